@@ -0,0 +1,242 @@
+// Native benchmark harness for the bliss library that pybliss wraps.
+//
+// Times graph construction, DIMACS I/O and the searches on the DIMACS files
+// given on the command line, without any Python overhead, so that the
+// numbers of benchmarks/run_benchmarks.py can be compared with the cost of
+// bliss itself. The instances are typically written by
+// ``python benchmarks/run_benchmarks.py --export-dimacs DIR``.
+//
+// Usage: pybliss_bench [--repeat R] FILE.dimacs... > results.json
+
+#include <algorithm>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace bliss;
+
+namespace {
+
+/**
+ * A graph read from a DIMACS file, kept as flat arrays so that construction
+ * can be timed apart from parsing.
+ */
+struct EdgeList {
+  unsigned int nvertices = 0;
+  std::vector<unsigned int> colors;
+  std::vector<unsigned int> edges;
+};
+
+/**
+ * Parses the DIMACS graph \p text as bliss does: a "p edge N M" line, "n v c"
+ * lines coloring the 1-based vertex v and "e v w" lines for the edges.
+ */
+EdgeList parse_dimacs(const std::string &text) {
+  EdgeList result;
+  const char *p = text.c_str();
+  bool seen_problem = false;
+  while (*p) {
+    const char *eol = std::strchr(p, '\n');
+    const std::string line(p, eol ? eol : p + std::strlen(p));
+    p = eol ? eol + 1 : p + line.size();
+    unsigned int a, b;
+    if (line.empty() || line[0] == 'c') {
+      continue;
+    } else if (std::sscanf(line.c_str(), "p edge %u %u", &a, &b) == 2) {
+      result.nvertices = a;
+      result.colors.assign(a, 0);
+      result.edges.reserve(2 * (size_t)b);
+      seen_problem = true;
+    } else if (seen_problem &&
+               std::sscanf(line.c_str(), "n %u %u", &a, &b) == 2 && a >= 1 &&
+               a <= result.nvertices) {
+      result.colors[a - 1] = b;
+    } else if (seen_problem &&
+               std::sscanf(line.c_str(), "e %u %u", &a, &b) == 2 && a >= 1 &&
+               b >= 1 && a <= result.nvertices && b <= result.nvertices) {
+      result.edges.push_back(a - 1);
+      result.edges.push_back(b - 1);
+    } else {
+      throw std::runtime_error("malformed DIMACS line: '" + line + "'");
+    }
+  }
+  if (!seen_problem) {
+    throw std::runtime_error("missing 'p edge' line");
+  }
+  return result;
+}
+
+std::string read_file(const char *path) {
+  std::unique_ptr<FILE, int (*)(FILE *)> fp(std::fopen(path, "rb"),
+                                            &std::fclose);
+  if (!fp) {
+    throw std::runtime_error(std::string("cannot open ") + path);
+  }
+  std::string text;
+  char buffer[1 << 16];
+  size_t n;
+  while ((n = std::fread(buffer, 1, sizeof(buffer), fp.get())) > 0) {
+    text.append(buffer, n);
+  }
+  return text;
+}
+
+std::unique_ptr<Graph> build_graph(const EdgeList &edge_list) {
+  auto g = std::make_unique<Graph>(edge_list.nvertices);
+  for (unsigned int v = 0; v < edge_list.nvertices; ++v) {
+    g->change_color(v, edge_list.colors[v]);
+  }
+  for (size_t i = 0; i < edge_list.edges.size(); i += 2) {
+    g->add_edge(edge_list.edges[i], edge_list.edges[i + 1]);
+  }
+  return g;
+}
+
+/**
+ * Returns the wall-clock times in seconds of \p repeat calls to \p body, each
+ * preceded by an untimed call to \p setup.
+ */
+std::vector<double> time_calls(unsigned int repeat,
+                               const std::function<void()> &setup,
+                               const std::function<void()> &body) {
+  std::vector<double> times;
+  for (unsigned int i = 0; i < repeat; ++i) {
+    setup();
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto end = std::chrono::steady_clock::now();
+    times.push_back(std::chrono::duration<double>(end - start).count());
+  }
+  return times;
+}
+
+std::string json_string(const std::string &s) {
+  std::string out = "\"";
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((unsigned char)c < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out += escaped;
+    } else {
+      out += c;
+    }
+  }
+  return out + "\"";
+}
+
+void print_result(bool first, const std::string &benchmark,
+                  const std::string &instance, const EdgeList &edge_list,
+                  std::vector<double> times) {
+  std::sort(times.begin(), times.end());
+  std::printf("%s\n    {\"benchmark\": %s, \"instance\": %s, "
+              "\"nvertices\": %u, \"nedges\": %zu, \"times\": [",
+              first ? "" : ",", json_string(benchmark).c_str(),
+              json_string(instance).c_str(), edge_list.nvertices,
+              edge_list.edges.size() / 2);
+  for (size_t i = 0; i < times.size(); ++i) {
+    std::printf("%s%.9g", i ? ", " : "", times[i]);
+  }
+  std::printf("], \"min\": %.9g, \"median\": %.9g}", times.front(),
+              times[times.size() / 2]);
+}
+
+void usage(const char *argv0) {
+  std::fprintf(stderr, "usage: %s [--repeat R] FILE.dimacs...\n", argv0);
+  std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  unsigned int repeat = 5;
+  std::vector<const char *> paths;
+  for (int i = 1; i < argc; ++i) {
+    if (!std::strcmp(argv[i], "--repeat") && i + 1 < argc) {
+      repeat = (unsigned int)std::strtoul(argv[++i], nullptr, 10);
+    } else if (argv[i][0] == '-') {
+      usage(argv[0]);
+    } else {
+      paths.push_back(argv[i]);
+    }
+  }
+  if (paths.empty() || repeat == 0) {
+    usage(argv[0]);
+  }
+
+  std::printf("{\n  \"harness\": \"native\",\n  \"repeat\": %u,\n"
+              "  \"results\": [",
+              repeat);
+  bool first = true;
+  for (const char *path : paths) {
+    std::string instance = path;
+    instance = instance.substr(instance.find_last_of("/\\") + 1);
+    std::string text;
+    EdgeList edge_list;
+    try {
+      text = read_file(path);
+      edge_list = parse_dimacs(text);
+    } catch (const std::exception &e) {
+      std::fprintf(stderr, "%s: %s\n", path, e.what());
+      return 1;
+    }
+
+    std::unique_ptr<Graph> g;
+    auto fresh_graph = [&] { g = build_graph(edge_list); };
+    auto run = [&](const char *benchmark, const std::function<void()> &setup,
+                   const std::function<void()> &body) {
+      print_result(first, benchmark, instance, edge_list,
+                   time_calls(repeat, setup, body));
+      first = false;
+    };
+
+    run("construct", [&] { g.reset(); }, [&] { g = build_graph(edge_list); });
+    std::unique_ptr<FILE, int (*)(FILE *)> fp(nullptr, &std::fclose);
+    run(
+        "read_dimacs",
+        [&] {
+          fp.reset(std::tmpfile());
+          std::fwrite(text.data(), 1, text.size(), fp.get());
+          std::rewind(fp.get());
+        },
+        [&] { g.reset(Graph::read_dimacs(fp.get())); });
+    run(
+        "write_dimacs",
+        [&] {
+          fresh_graph();
+          fp.reset(std::tmpfile());
+        },
+        [&] {
+          g->write_dimacs(fp.get());
+          std::fflush(fp.get());
+        });
+    fp.reset();
+    // Every search runs on a fresh graph so that all runs do the same work.
+    run("canonical_form", fresh_graph, [&] {
+      Stats stats;
+      g->canonical_form(stats);
+    });
+    run("find_automorphisms", fresh_graph, [&] {
+      Stats stats;
+      g->find_automorphisms(stats);
+    });
+    run("find_automorphisms_report", fresh_graph, [&] {
+      Stats stats;
+      size_t n_reported = 0;
+      g->find_automorphisms(
+          stats, [&](unsigned int, const unsigned int *) { ++n_reported; });
+    });
+  }
+  std::printf("\n  ]\n}\n");
+  return 0;
+}
@@ -0,0 +1,197 @@
+"""
+Generators for the graph families of the benchmark suite.
+
+Every generator is deterministic: random families take an explicit seed, so
+that the same instances are benchmarked on every commit. A generator returns
+an :class:`Instance`, whose edges are listed once per undirected edge, with
+0-based vertices.
+"""
+
+from __future__ import annotations
+
+import random
+from collections.abc import Callable
+from dataclasses import dataclass, field
+from itertools import combinations
+
+
+@dataclass(frozen=True)
+class Instance:
+    family: str
+    parameter: int
+    nvertices: int
+    edges: list[tuple[int, int]]
+    colors: list[int] = field(default_factory=list)
+
+    @property
+    def name(self) -> str:
+        return f"{self.family}-{self.parameter}"
+
+    def to_dimacs(self) -> str:
+        lines = [f"p edge {self.nvertices} {len(self.edges)}"]
+        lines.extend(
+            f"n {v + 1} {color}"
+            for v, color in enumerate(self.colors)
+            if color != 0
+        )
+        lines.extend(f"e {v + 1} {w + 1}" for v, w in self.edges)
+        return "\n".join(lines) + "\n"
+
+
+def _random_regular_edges(
+    nvertices: int, degree: int, rng: random.Random
+) -> list[tuple[int, int]]:
+    # Pairing model, rejecting pairings with self-loops or multi-edges. For
+    # small degrees a simple pairing is drawn with constant probability.
+    if (nvertices * degree) % 2 or degree >= nvertices:
+        raise ValueError("no simple graph with these parameters")
+    stubs = [v for v in range(nvertices) for _ in range(degree)]
+    while True:
+        rng.shuffle(stubs)
+        edges = set()
+        for v, w in zip(stubs[::2], stubs[1::2]):
+            edge = (min(v, w), max(v, w))
+            if v == w or edge in edges:
+                break
+            edges.add(edge)
+        else:
+            return sorted(edges)
+
+
+def random_regular(n: int, degree: int = 3, seed: int = 0) -> Instance:
+    """A uniformly random simple *degree*-regular graph on *n* vertices."""
+    edges = _random_regular_edges(n, degree, random.Random(seed))
+    return Instance("random_regular", n, n, edges)
+
+
+def grid(k: int) -> Instance:
+    """The :math:`k \\times k` grid graph."""
+    edges = []
+    for i in range(k):
+        for j in range(k):
+            v = i * k + j
+            if j + 1 < k:
+                edges.append((v, v + 1))
+            if i + 1 < k:
+                edges.append((v, v + k))
+    return Instance("grid", k, k * k, edges)
+
+
+def paley(q: int) -> Instance:
+    """
+    The Paley graph of order *q*, a prime congruent to 1 modulo 4: vertices
+    are adjacent if their difference is a nonzero square modulo *q*. Paley
+    graphs are strongly regular.
+    """
+    if q % 4 != 1 or any(q % d == 0 for d in range(2, int(q**0.5) + 1)):
+        raise ValueError("q must be a prime congruent to 1 modulo 4")
+    squares = {(x * x) % q for x in range(1, q)}
+    edges = [(v, w) for v, w in combinations(range(q), 2) if w - v in squares]
+    return Instance("paley", q, q, edges)
+
+
+def _cfi(
+    family: str,
+    parameter: int,
+    base_nvertices: int,
+    base_edges: list[tuple[int, int]],
+) -> Instance:
+    # Cai-Fuerer-Immerman construction: every base vertex v of degree d
+    # becomes the 2^(d-1) "middle" vertices for the even subsets S of its
+    # incident edges, and two "end" vertices (v, e, 0) and (v, e, 1) for every
+    # incident edge e, the middle vertex S being adjacent to (v, e, e in S).
+    # The end vertices of a base edge are joined in parallel, except for the
+    # first base edge that is twisted.
+    incident: list[list[int]] = [[] for _ in range(base_nvertices)]
+    for e, (u, v) in enumerate(base_edges):
+        incident[u].append(e)
+        incident[v].append(e)
+
+    nvertices = 0
+    end_vertex = {}
+    edges = []
+    for v in range(base_nvertices):
+        for e in incident[v]:
+            end_vertex[v, e] = nvertices
+            nvertices += 2
+        degree = len(incident[v])
+        for subset in range(1 << degree):
+            if bin(subset).count("1") % 2:
+                continue
+            middle = nvertices
+            nvertices += 1
+            for i, e in enumerate(incident[v]):
+                edges.append((end_vertex[v, e] + ((subset >> i) & 1), middle))
+
+    for e, (u, v) in enumerate(base_edges):
+        twist = 1 if e == 0 else 0
+        for i in range(2):
+            edges.append((end_vertex[u, e] + i, end_vertex[v, e] + (i ^ twist)))
+
+    return Instance(family, parameter, nvertices, edges)
+
+
+def cfi(n: int, seed: int = 0) -> Instance:
+    """
+    The twisted Cai-Fuerer-Immerman graph over a random cubic graph on *n*
+    vertices. CFI graphs are not distinguished by color refinement.
+    """
+    base_edges = _random_regular_edges(n, 3, random.Random(seed))
+    return _cfi("cfi", n, n, base_edges)
+
+
+def miyazaki(k: int) -> Instance:
+    """
+    A Miyazaki-style graph: the twisted CFI graph over the circular ladder
+    with *k* rungs, on which individualization-refinement needs many
+    backtracks.
+    """
+    base_edges = []
+    for i in range(k):
+        j = (i + 1) % k
+        base_edges.extend([(i, j), (k + i, k + j), (i, k + i)])
+    return _cfi("miyazaki", k, 2 * k, base_edges)
+
+
+FAMILIES: dict[str, Callable[[int], Instance]] = {
+    "random_regular": random_regular,
+    "grid": grid,
+    "paley": paley,
+    "cfi": cfi,
+    "miyazaki": miyazaki,
+}
+
+# The family parameters used for every size preset.
+SIZES: dict[str, dict[str, list[int]]] = {
+    "small": {
+        "random_regular": [100, 1000],
+        "grid": [10, 30],
+        "paley": [13, 29],
+        "cfi": [10, 20],
+        "miyazaki": [4, 8],
+    },
+    "medium": {
+        "random_regular": [10_000],
+        "grid": [100],
+        "paley": [101, 197],
+        "cfi": [50, 100],
+        "miyazaki": [16, 32],
+    },
+    "large": {
+        "random_regular": [100_000],
+        "grid": [300],
+        "paley": [401, 809],
+        "cfi": [200],
+        "miyazaki": [64],
+    },
+}
+
+
+def generate(sizes: list[str], families: list[str]) -> list[Instance]:
+    """Returns the instances of *families* for the presets *sizes*."""
+    return [
+        FAMILIES[family](parameter)
+        for size in sizes
+        for family in families
+        for parameter in SIZES[size][family]
+    ]
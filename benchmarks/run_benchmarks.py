@@ -0,0 +1,323 @@
+"""
+Benchmarks of the pybliss bindings on the graph families of
+:mod:`families`, covering graph construction, export, I/O, canonical
+labeling, automorphism search and the overhead of Python callbacks.
+
+Usage::
+
+    python benchmarks/run_benchmarks.py --size small -o results.json
+    python benchmarks/run_benchmarks.py --compare base.json results.json
+    python benchmarks/run_benchmarks.py --size medium --export-dimacs DIR
+
+The results are written as JSON: a ``"meta"`` object describing the run
+(commit, versions, machine) and a ``"results"`` list with the timings in
+seconds of every benchmark on every instance. ``--compare`` prints the
+ratios of the median times of two such files. ``--export-dimacs`` writes the
+instances as DIMACS files for the native harness, which times bliss itself
+on them::
+
+    pip install . -Ccmake.define.PYBLISS_BUILD_BENCHMARKS=ON
+    build/<wheel tag>/pybliss_bench DIR/*.dimacs > native.json
+"""
+
+from __future__ import annotations
+
+import argparse
+import gc
+import json
+import os
+import platform
+import subprocess
+import sys
+import time
+from collections.abc import Callable
+from datetime import datetime, timezone
+from typing import Any
+
+import numpy as np
+from families import FAMILIES, SIZES, Instance, generate
+
+import pybliss as bliss
+
+
+# A benchmark maps an instance to a pair of callables (setup, body): setup
+# runs untimed before every timed call to body and returns its argument.
+Benchmark = Callable[[Instance], tuple]
+
+
+def _arrays(inst: Instance) -> tuple[np.ndarray, np.ndarray]:
+    edges = np.array(inst.edges, dtype=np.uint32).reshape(-1, 2)
+    colors = np.zeros(inst.nvertices, dtype=np.uint32)
+    colors[: len(inst.colors)] = inst.colors
+    return edges, colors
+
+
+def _graph(inst: Instance) -> bliss.Graph:
+    return bliss.Graph.from_edge_array(inst.nvertices, *_arrays(inst))
+
+
+def bench_from_edge_array(inst):
+    edges, colors = _arrays(inst)
+    return (
+        lambda: None,
+        lambda _: bliss.Graph.from_edge_array(inst.nvertices, edges, colors),
+    )
+
+
+def bench_from_csr(inst):
+    indptr, indices, colors = _graph(inst).to_csr()
+    return (
+        lambda: None,
+        lambda _: bliss.Graph.from_csr(indptr, indices, colors),
+    )
+
+
+def bench_add_edge(inst):
+    def body(_):
+        g = bliss.Graph(inst.nvertices)
+        for v, w in inst.edges:
+            g.add_edge(v, w)
+
+    return lambda: None, body
+
+
+def bench_to_edge_array(inst):
+    return lambda: _graph(inst), lambda g: g.to_edge_array()
+
+
+def bench_to_dimacs(inst):
+    return lambda: _graph(inst), lambda g: g.to_dimacs()
+
+
+def bench_from_dimacs(inst):
+    dimacs = _graph(inst).to_dimacs()
+    return lambda: None, lambda _: bliss.Graph.from_dimacs(dimacs)
+
+
+def bench_to_bytes(inst):
+    return lambda: _graph(inst), lambda g: g.to_bytes()
+
+
+def bench_from_bytes(inst):
+    data = _graph(inst).to_bytes()
+    return lambda: None, lambda _: bliss.Graph.from_bytes(data)
+
+
+# The searches run on a fresh graph every time so that all runs do the same
+# work.
+
+
+def bench_canonical_labeling(inst):
+    return (
+        lambda: _graph(inst),
+        lambda g: g.get_permutation_to_canonical_form(bliss.Stats()),
+    )
+
+
+def bench_canonical_certificate(inst):
+    return (
+        lambda: _graph(inst),
+        lambda g: g.canonical_certificate(bliss.Stats()),
+    )
+
+
+def bench_automorphism_generators(inst):
+    return (
+        lambda: _graph(inst),
+        lambda g: g.automorphism_generators(bliss.Stats()),
+    )
+
+
+def bench_find_automorphisms(inst):
+    return lambda: _graph(inst), lambda g: g.find_automorphisms(bliss.Stats())
+
+
+def bench_find_automorphisms_report(inst):
+    # Compared with find_automorphisms, measures the cost of calling back
+    # into Python for every generator.
+    def report(n, perm):
+        pass
+
+    return (
+        lambda: _graph(inst),
+        lambda g: g.find_automorphisms(bliss.Stats(), report),
+    )
+
+
+def bench_find_automorphisms_terminate(inst):
+    # Measures the cost of polling a Python termination callback at every
+    # search node.
+    return (
+        lambda: _graph(inst),
+        lambda g: g.find_automorphisms(bliss.Stats(), None, lambda: False),
+    )
+
+
+BENCHMARKS: dict[str, Benchmark] = {
+    name[len("bench_") :]: func
+    for name, func in globals().items()
+    if name.startswith("bench_")
+}
+
+# add_edge measures the per-call overhead of the bindings: on the largest
+# instances it would mostly measure the Python interpreter.
+MAX_EDGES = {"add_edge": 100_000}
+
+
+def time_benchmark(
+    benchmark: Benchmark, inst: Instance, repeat: int
+) -> list[float]:
+    setup, body = benchmark(inst)
+    times = []
+    # As timeit does, keep the garbage collector out of the timings.
+    gc_was_enabled = gc.isenabled()
+    gc.disable()
+    try:
+        for _ in range(repeat):
+            arg = setup()
+            start = time.perf_counter()
+            body(arg)
+            times.append(time.perf_counter() - start)
+    finally:
+        if gc_was_enabled:
+            gc.enable()
+    return times
+
+
+def get_meta(args: argparse.Namespace) -> dict[str, Any]:
+    try:
+        commit = subprocess.run(
+            ["git", "rev-parse", "HEAD"],
+            cwd=os.path.dirname(os.path.abspath(__file__)),
+            capture_output=True,
+            text=True,
+            check=True,
+        ).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        commit = None
+
+    try:
+        from importlib.metadata import version
+
+        pybliss_version = version("pybliss")
+    except Exception:
+        pybliss_version = None
+
+    return {
+        "harness": "python",
+        "commit": commit,
+        "pybliss": pybliss_version,
+        "numpy": np.__version__,
+        "python": platform.python_version(),
+        "platform": platform.platform(),
+        "machine": platform.machine(),
+        "cpu_count": os.cpu_count(),
+        "date": datetime.now(timezone.utc).isoformat(timespec="seconds"),
+        "repeat": args.repeat,
+        "sizes": args.size,
+    }
+
+
+def run(args: argparse.Namespace) -> dict[str, Any]:
+    results = []
+    instances = generate(args.size, args.family)
+    for inst in instances:
+        for name in args.benchmark:
+            if len(inst.edges) > MAX_EDGES.get(name, len(inst.edges)):
+                continue
+            times = sorted(time_benchmark(BENCHMARKS[name], inst, args.repeat))
+            results.append({
+                "benchmark": name,
+                "instance": inst.name,
+                "family": inst.family,
+                "parameter": inst.parameter,
+                "nvertices": inst.nvertices,
+                "nedges": len(inst.edges),
+                "times": times,
+                "min": times[0],
+                "median": times[len(times) // 2],
+            })
+            print(
+                f"{name:32} {inst.name:24} {times[len(times) // 2]:.3e} s",
+                file=sys.stderr,
+            )
+    return {"meta": get_meta(args), "results": results}
+
+
+def compare(base_path: str, new_path: str) -> None:
+    def load(path):
+        with open(path) as f:
+            return {
+                (r["benchmark"], r["instance"]): r["median"]
+                for r in json.load(f)["results"]
+            }
+
+    base, new = load(base_path), load(new_path)
+    print(f"{'benchmark':32} {'instance':24} {'base':>10} {'new':>10} ratio")
+    for key in sorted(base.keys() & new.keys()):
+        ratio = new[key] / base[key] if base[key] else float("inf")
+        print(
+            f"{key[0]:32} {key[1]:24} {base[key]:10.3e} {new[key]:10.3e} "
+            f"{ratio:.2f}"
+        )
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description=__doc__.split("\n\n")[1],
+        formatter_class=argparse.RawDescriptionHelpFormatter,
+    )
+    parser.add_argument(
+        "--size", nargs="+", choices=list(SIZES), default=["small"]
+    )
+    parser.add_argument(
+        "--family", nargs="+", choices=list(FAMILIES), default=list(FAMILIES)
+    )
+    parser.add_argument(
+        "--benchmark",
+        nargs="+",
+        choices=list(BENCHMARKS),
+        default=list(BENCHMARKS),
+    )
+    parser.add_argument("--repeat", type=int, default=5)
+    parser.add_argument(
+        "-o", "--output", help="write the JSON results to this file"
+    )
+    parser.add_argument(
+        "--compare",
+        nargs=2,
+        metavar=("BASE", "NEW"),
+        help="compare two result files instead of running the benchmarks",
+    )
+    parser.add_argument(
+        "--export-dimacs",
+        metavar="DIR",
+        help="write the instances to DIR as DIMACS files and exit",
+    )
+    args = parser.parse_args()
+
+    if args.compare:
+        compare(*args.compare)
+        return
+
+    if args.export_dimacs:
+        os.makedirs(args.export_dimacs, exist_ok=True)
+        for inst in generate(args.size, args.family):
+            path = os.path.join(args.export_dimacs, f"{inst.name}.dimacs")
+            with open(path, "w") as f:
+                f.write(inst.to_dimacs())
+        return
+
+    if args.repeat < 1:
+        parser.error("--repeat must be positive")
+
+    output = json.dumps(run(args), indent=2)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(output + "\n")
+    else:
+        print(output)
+
+
+if __name__ == "__main__":
+    main()
@@ -136,4 +136,5 @@ intersphinx_mapping = {
     "numpy": ("https://numpy.org/doc/stable/", None),
     "python": ("https://docs.python.org/3/", None),
     "pytools": ("https://documen.tician.de/pytools/", None),
+    "scipy": ("https://docs.scipy.org/doc/scipy/", None),
 }
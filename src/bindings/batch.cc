@@ -0,0 +1,209 @@
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <cstring>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/vector.h>
+#include <optional>
+#include <pybliss_ext.h>
+#include <pybliss_parallel.h>
+#include <pybliss_refinement.h>
+#include <vector>
+
+using namespace bliss;
+
+/**
+ * Per-graph search statistics of a batch stored as struct-of-arrays, so that
+ * each column can be handed over to numpy without copying.
+ */
+struct StatsColumns {
+  std::unique_ptr<double[]> group_size_approx;
+  std::unique_ptr<uint64_t[]> n_nodes;
+  std::unique_ptr<uint64_t[]> n_leaf_nodes;
+  std::unique_ptr<uint64_t[]> n_bad_nodes;
+  std::unique_ptr<uint64_t[]> n_canupdates;
+  std::unique_ptr<uint64_t[]> n_generators;
+  std::unique_ptr<uint64_t[]> max_level;
+  size_t size;
+
+  explicit StatsColumns(size_t n)
+      : group_size_approx(new double[n]), n_nodes(new uint64_t[n]),
+        n_leaf_nodes(new uint64_t[n]), n_bad_nodes(new uint64_t[n]),
+        n_canupdates(new uint64_t[n]), n_generators(new uint64_t[n]),
+        max_level(new uint64_t[n]), size(n) {}
+
+  void record(size_t i, const Stats &stats) {
+    group_size_approx[i] = (double)stats.get_group_size_approx();
+    n_nodes[i] = stats.get_nof_nodes();
+    n_leaf_nodes[i] = stats.get_nof_leaf_nodes();
+    n_bad_nodes[i] = stats.get_nof_bad_nodes();
+    n_canupdates[i] = stats.get_nof_canupdates();
+    n_generators[i] = stats.get_nof_generators();
+    max_level[i] = stats.get_max_level();
+  }
+
+  void copy_row(size_t dst, size_t src) {
+    group_size_approx[dst] = group_size_approx[src];
+    n_nodes[dst] = n_nodes[src];
+    n_leaf_nodes[dst] = n_leaf_nodes[src];
+    n_bad_nodes[dst] = n_bad_nodes[src];
+    n_canupdates[dst] = n_canupdates[src];
+    n_generators[dst] = n_generators[src];
+    max_level[dst] = max_level[src];
+  }
+
+  /**
+   * Returns the columns as a :class:`dict` mapping the names of the
+   * :class:`Stats` attributes to numpy arrays. The arrays take ownership of
+   * the columns' buffers.
+   */
+  nb::dict to_dict() {
+    nb::dict result;
+    result["group_size_approx"] =
+        make_owned_ndarray(group_size_approx.release(), {size});
+    result["n_nodes"] = make_owned_ndarray(n_nodes.release(), {size});
+    result["n_leaf_nodes"] = make_owned_ndarray(n_leaf_nodes.release(), {size});
+    result["n_bad_nodes"] = make_owned_ndarray(n_bad_nodes.release(), {size});
+    result["n_canupdates"] = make_owned_ndarray(n_canupdates.release(), {size});
+    result["n_generators"] = make_owned_ndarray(n_generators.release(), {size});
+    result["max_level"] = make_owned_ndarray(max_level.release(), {size});
+    return result;
+  }
+};
+
+template <typename GraphT>
+static nb::tuple
+canonicalize_many(const std::vector<GraphT *> &graphs, unsigned int n_threads,
+                  std::optional<typename GraphT::SplittingHeuristic> shs) {
+  const size_t n_graphs = graphs.size();
+  const size_t nvertices = n_graphs ? graphs[0]->get_nof_vertices() : 0;
+
+  for (size_t i = 0; i < n_graphs; ++i) {
+    if (!graphs[i]) {
+      throw std::runtime_error("Entries of 'graphs' cannot be None.");
+    }
+    if (graphs[i]->get_nof_vertices() != nvertices) {
+      throw std::runtime_error(
+          "All graphs must have the same number of vertices.");
+    }
+  }
+  std::vector<size_t> first_occurrence;
+  const std::vector<size_t> unique_ids =
+      find_first_occurrences(graphs, first_occurrence);
+
+  std::unique_ptr<uint32_t[]> labelings(new uint32_t[n_graphs * nvertices]);
+  StatsColumns stats_columns(n_graphs);
+
+  {
+    nb::gil_scoped_release release;
+    parallel_for(unique_ids.size(), n_threads, [&](size_t i, unsigned int) {
+      const size_t igraph = unique_ids[i];
+      GraphT *graph = graphs[igraph];
+      if (shs) {
+        graph->set_splitting_heuristic(*shs);
+      }
+      Stats stats;
+      const unsigned int *perm = graph->canonical_form(stats);
+      if (nvertices) {
+        std::memcpy(&labelings[igraph * nvertices], perm,
+                    sizeof(uint32_t) * nvertices);
+      }
+      stats_columns.record(igraph, stats);
+    });
+
+    for (size_t i = 0; i < n_graphs; ++i) {
+      if (first_occurrence[i] != i) {
+        std::memcpy(&labelings[i * nvertices],
+                    &labelings[first_occurrence[i] * nvertices],
+                    sizeof(uint32_t) * nvertices);
+        stats_columns.copy_row(i, first_occurrence[i]);
+      }
+    }
+  }
+
+  return nb::make_tuple(
+      make_owned_ndarray(labelings.release(), {n_graphs, nvertices}),
+      stats_columns.to_dict());
+}
+
+static const char *canonicalize_many_doc =
+    "Returns ``(labelings, stats)`` for the canonical labelings of *graphs*, "
+    "a sequence of :class:`Graph` or a sequence of :class:`Digraph`, "
+    "all having the same number of vertices :math:`N`. The graphs are "
+    "canonicalized on a pool of native threads that balance the work by "
+    "work-stealing, the GIL is released throughout.\n\n"
+    "- *labelings* is a C-contiguous :class:`numpy.ndarray` of dtype "
+    "``uint32`` and shape :math:`(len(graphs), N)`. Its i-th row is what "
+    ":meth:`Graph.get_permutation_to_canonical_form` returns for "
+    "``graphs[i]``.\n"
+    "- *stats* is a :class:`dict` mapping the :class:`Stats` attribute "
+    "names ``group_size_approx``, ``n_nodes``, ``n_leaf_nodes``, "
+    "``n_bad_nodes``, ``n_canupdates``, ``n_generators`` and ``max_level`` "
+    "to 1D :class:`numpy.ndarray` s with an entry per graph.\n\n"
+    ":arg n_threads: Number of native threads. Defaults to one per hardware "
+    "thread.\n"
+    ":arg splitting_heuristic: If not *None*, it is set as the splitting "
+    "heuristic of every graph (see :meth:`Graph.set_splitting_heuristic`) "
+    "before canonicalizing it.\n\n"
+    "Entries of *graphs* that refer to the same object are canonicalized "
+    "once. *graphs* must not be modified or searched by other threads while "
+    "this function runs.";
+
+template <typename GraphT>
+static nb::list refinement_invariants(const std::vector<GraphT *> &graphs,
+                                      unsigned int n_threads) {
+  const size_t n_graphs = graphs.size();
+  for (size_t i = 0; i < n_graphs; ++i) {
+    if (!graphs[i]) {
+      throw std::runtime_error("Entries of 'graphs' cannot be None.");
+    }
+  }
+  std::vector<size_t> first_occurrence;
+  const std::vector<size_t> unique_ids =
+      find_first_occurrences(graphs, first_occurrence);
+
+  std::vector<Hash128> hashes(n_graphs);
+  {
+    nb::gil_scoped_release release;
+    std::vector<std::vector<uint32_t>> colors(resolve_n_threads(n_threads));
+    parallel_for(unique_ids.size(), n_threads,
+                 [&](size_t i, unsigned int worker) {
+                   const size_t igraph = unique_ids[i];
+                   hashes[igraph] =
+                       refine_colors(*graphs[igraph], colors[worker]);
+                 });
+  }
+
+  nb::list result;
+  for (size_t i = 0; i < n_graphs; ++i) {
+    const Hash128 &hash = hashes[first_occurrence[i]];
+    result.append(uint128_to_int(hash.lo, hash.hi));
+  }
+  return result;
+}
+
+static const char *refinement_invariants_doc =
+    "Returns the list of the hashes that :meth:`Graph.refinement_invariant` "
+    "returns for each of *graphs*, a sequence of :class:`Graph` or a "
+    "sequence of :class:`Digraph`, of any sizes. The graphs are refined on "
+    "*n_threads* native threads (one per hardware thread if 0), the GIL is "
+    "released throughout.\n\n"
+    "Graphs with different hashes are not isomorphic, so that only graphs "
+    "with equal hashes need be told apart by :func:`canonicalize_many` or "
+    ":meth:`Graph.canonical_certificate`. *graphs* must not be modified or "
+    "searched by other threads while this function runs.";
+
+void bind_batch(nb::module_ &m) {
+  m.def("canonicalize_many", &canonicalize_many<Graph>, "graphs"_a,
+        "n_threads"_a = 0, "splitting_heuristic"_a = nb::none(),
+        canonicalize_many_doc);
+  m.def("canonicalize_many", &canonicalize_many<Digraph>, "graphs"_a,
+        "n_threads"_a = 0, "splitting_heuristic"_a = nb::none(),
+        canonicalize_many_doc);
+  m.def("refinement_invariants", &refinement_invariants<Graph>, "graphs"_a,
+        "n_threads"_a = 0, refinement_invariants_doc);
+  m.def("refinement_invariants", &refinement_invariants<Digraph>, "graphs"_a,
+        "n_threads"_a = 0, refinement_invariants_doc);
+}
@@ -11,6 +11,7 @@ void bind_bignum(nb::module_ &m) {
                      ".. automethod:: assign\n"
                      ".. automethod:: multiply\n"
                      ".. automethod:: print_to_file\n"
+                     ".. automethod:: __int__\n"
                      ".. automethod:: __str__")
       .def(nb::init<>())
       .def("assign", &BigNum::assign)
@@ -21,10 +22,11 @@ void bind_bignum(nb::module_ &m) {
              self.print(fp);
              fflush(fp);
            })
-      // FIXME: Add a to_python method.
+      .def("__int__", &bignum_to_int,
+           "Returns the value of this number as a Python :class:`int`.")
       .def("__str__", [](BigNum &self) {
-        return nb::str(capture_string_written_to_file([&](FILE *fp) {
-                         self.print(fp);
-                       }).c_str());
+        const std::string num_str =
+            capture_string_written_to_file([&](FILE *fp) { self.print(fp); });
+        return nb::str(num_str.data(), num_str.size());
       });
 }
\ No newline at end of file
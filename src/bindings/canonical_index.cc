@@ -0,0 +1,649 @@
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/pair.h>
+#include <nanobind/stl/vector.h>
+#include <optional>
+#include <pybliss_certificate.h>
+#include <pybliss_ext.h>
+#include <pybliss_parallel.h>
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace bliss;
+
+// {{{ storage
+
+/**
+ * A read-only memory mapping of a whole file. Falls back to reading the file
+ * into memory where memory-mapping is not available.
+ */
+class FileMapping {
+public:
+  explicit FileMapping(const char *path) {
+#if defined(_WIN32)
+    FILE *fp = std::fopen(path, "rb");
+    if (!fp) {
+      throw std::runtime_error(std::string("Failed to open '") + path + "'.");
+    }
+    char buf[1 << 16];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+      contents.append(buf, n);
+    }
+    std::fclose(fp);
+    addr = contents.data();
+    length = contents.size();
+#else
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("Failed to open '") + path + "'.");
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      throw std::runtime_error(std::string("Failed to stat '") + path + "'.");
+    }
+    length = st.st_size;
+    if (length) {
+      void *mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error(std::string("Failed to memory-map '") +
+                                 path + "'.");
+      }
+      addr = (const char *)mapped;
+    }
+    close(fd); // The mapping outlives the file descriptor.
+#endif
+  }
+
+  ~FileMapping() {
+#if !defined(_WIN32)
+    if (addr) {
+      munmap((void *)addr, length);
+    }
+#endif
+  }
+
+  FileMapping(const FileMapping &) = delete;
+  FileMapping &operator=(const FileMapping &) = delete;
+
+  const char *data() const { return addr; }
+  size_t size() const { return length; }
+
+private:
+  const char *addr = nullptr;
+  size_t length = 0;
+#if defined(_WIN32)
+  std::string contents;
+#endif
+};
+
+/**
+ * An array that either views memory owned by a FileMapping or owns its
+ * elements. Views are copied into owned memory on their first modification,
+ * so that a loaded index can be queried without reading it whole.
+ */
+template <typename T> class Column {
+public:
+  size_t size() const { return n; }
+  const T *data() const { return ptr; }
+  const T &operator[](size_t i) const { return ptr[i]; }
+
+  void view(const T *data, size_t size) {
+    owned.clear();
+    owned.shrink_to_fit();
+    ptr = data;
+    n = size;
+  }
+
+  void set(size_t i, const T &value) {
+    make_owned();
+    owned[i] = value;
+  }
+
+  void append(const T *data, size_t size) {
+    make_owned();
+    owned.insert(owned.end(), data, data + size);
+    sync();
+  }
+
+  void push_back(const T &value) { append(&value, 1); }
+
+  void assign(size_t size, const T &value) {
+    owned.assign(size, value);
+    sync();
+  }
+
+  void replace(std::vector<T> &&values) {
+    owned = std::move(values);
+    sync();
+  }
+
+private:
+  std::vector<T> owned;
+  const T *ptr = nullptr;
+  size_t n = 0;
+
+  void make_owned() {
+    if (ptr != owned.data()) {
+      std::vector<T> copy(ptr, ptr + n);
+      owned.swap(copy);
+      sync();
+    }
+  }
+
+  void sync() {
+    ptr = owned.data();
+    n = owned.size();
+  }
+};
+
+// }}}
+
+// {{{ CanonicalIndex
+
+/**
+ * Header of the file written by CanonicalIndex::save. It is followed by the
+ * slots, the certificate offsets, the per-class hashes and the certificate
+ * arena, in this order. All integers are in the native byte order, which is
+ * checked on load through \p byte_order.
+ */
+struct IndexFileHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint64_t n_classes;
+  uint64_t n_slots;
+  uint64_t arena_size;
+};
+
+static const char index_magic[8] = {'P', 'Y', 'B', 'L', 'I', 'S', 'S', 'I'};
+static const uint32_t index_version = 1;
+static const uint32_t index_byte_order = 0x01020304;
+
+/**
+ * A set of isomorphism classes, each stored as the certificate of its
+ * canonical form (see make_certificate). Classes are numbered by insertion
+ * order.
+ *
+ * The certificates are stored back to back in an arena. Lookups go through
+ * an open-addressing hash table with linear probing whose slots pack the
+ * 24-bit tag and the class id + 1 of an entry in 64 bits, 0 marking an empty
+ * slot. Only certificates whose tags match are compared.
+ *
+ * All members are safe to call concurrently: lookups share a reader lock,
+ * insertions take the writer lock.
+ */
+class CanonicalIndex {
+public:
+  CanonicalIndex() {
+    slots.assign(initial_n_slots, 0);
+    offsets.push_back(0);
+  }
+
+  size_t size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return hashes.size();
+  }
+
+  /**
+   * Returns the id of the class of \p certificate, or std::nullopt if the
+   * index does not contain it.
+   */
+  std::optional<uint64_t> find(const std::string &certificate,
+                               const Hash128 &hash) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    size_t islot;
+    return find_slot(certificate, hash, islot);
+  }
+
+  /**
+   * Returns the id of the class of \p certificate, adding the class if
+   * needed, and whether it was added.
+   */
+  std::pair<uint64_t, bool> insert(const std::string &certificate,
+                                   const Hash128 &hash) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return insert_locked(certificate, hash);
+  }
+
+  /**
+   * Inserts the \p n certificates of \p certificates as insert does, holding
+   * the writer lock once for all of them.
+   */
+  void insert_many(const std::string *certificates,
+                   const Hash128 *certificate_hashes, size_t n,
+                   uint64_t *class_ids, bool *is_new) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    for (size_t i = 0; i < n; ++i) {
+      std::tie(class_ids[i], is_new[i]) =
+          insert_locked(certificates[i], certificate_hashes[i]);
+    }
+  }
+
+  /**
+   * Returns the certificate of the class \p class_id.
+   */
+  std::string certificate(uint64_t class_id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (class_id >= hashes.size()) {
+      throw std::out_of_range("Class id out of range.");
+    }
+    return std::string(arena.data() + offsets[class_id],
+                       offsets[class_id + 1] - offsets[class_id]);
+  }
+
+  void save(const char *path) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    IndexFileHeader header;
+    std::memcpy(header.magic, index_magic, sizeof(index_magic));
+    header.version = index_version;
+    header.byte_order = index_byte_order;
+    header.n_classes = hashes.size();
+    header.n_slots = slots.size();
+    header.arena_size = arena.size();
+
+    FILE *fp = std::fopen(path, "wb");
+    if (!fp) {
+      throw std::runtime_error(std::string("Failed to open '") + path +
+                               "' for writing.");
+    }
+    const bool ok =
+        std::fwrite(&header, sizeof(header), 1, fp) == 1 &&
+        write_column(fp, slots) && write_column(fp, offsets) &&
+        write_column(fp, hashes) && write_column(fp, arena);
+    if (std::fclose(fp) != 0 || !ok) {
+      throw std::runtime_error(std::string("Failed to write '") + path +
+                               "'.");
+    }
+  }
+
+  static CanonicalIndex *load(const char *path) {
+    auto mapping = std::make_shared<FileMapping>(path);
+    const char *data = mapping->data();
+    const size_t size = mapping->size();
+
+    IndexFileHeader header;
+    if (size < sizeof(header)) {
+      throw std::runtime_error("Not a canonical index file.");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, index_magic, sizeof(index_magic)) != 0) {
+      throw std::runtime_error("Not a canonical index file.");
+    }
+    if (header.version != index_version) {
+      throw std::runtime_error("Unsupported canonical index file version.");
+    }
+    if (header.byte_order != index_byte_order) {
+      throw std::runtime_error(
+          "Canonical index file was written on a machine with a different "
+          "byte order.");
+    }
+    const uint64_t n_slots = header.n_slots, n_classes = header.n_classes;
+    // Every column fits in the file, which bounds the terms of the expected
+    // size so that their sum cannot overflow.
+    const uint64_t max_count = size / sizeof(uint64_t);
+    if (n_slots > max_count || n_classes >= max_count ||
+        header.arena_size > size) {
+      throw std::runtime_error("Corrupt canonical index file.");
+    }
+    const uint64_t expected_size =
+        sizeof(header) +
+        sizeof(uint64_t) * (n_slots + (n_classes + 1) + n_classes) +
+        header.arena_size;
+    if (size != expected_size || n_slots == 0 ||
+        (n_slots & (n_slots - 1)) != 0 || n_classes >= n_slots) {
+      throw std::runtime_error("Corrupt canonical index file.");
+    }
+
+    auto index = std::make_unique<CanonicalIndex>();
+    const char *p = data + sizeof(header);
+    index->slots.view((const uint64_t *)p, n_slots);
+    p += sizeof(uint64_t) * n_slots;
+    index->offsets.view((const uint64_t *)p, n_classes + 1);
+    p += sizeof(uint64_t) * (n_classes + 1);
+    index->hashes.view((const uint64_t *)p, n_classes);
+    p += sizeof(uint64_t) * n_classes;
+    index->arena.view(p, header.arena_size);
+    if (!index->is_consistent()) {
+      throw std::runtime_error("Corrupt canonical index file.");
+    }
+    index->mapping = std::move(mapping);
+    return index.release();
+  }
+
+private:
+  static constexpr size_t initial_n_slots = 1024;
+  static constexpr int id_bits = 40;
+  static constexpr uint64_t id_mask = ((uint64_t)1 << id_bits) - 1;
+
+  Column<uint64_t> slots;
+  Column<uint64_t> offsets;
+  Column<uint64_t> hashes;
+  Column<char> arena;
+  std::shared_ptr<FileMapping> mapping;
+  mutable std::shared_mutex mutex;
+
+  static uint64_t tag_of(uint64_t hash) { return hash >> id_bits; }
+
+  /**
+   * Returns whether the columns can be queried safely: the offsets go from
+   * 0 to the arena size without decreasing, every occupied slot holds a
+   * valid class id, and there is one occupied slot per class, which leaves
+   * the empty slots that end the probe sequences. Reads the slots and
+   * offsets whole, but not the arena.
+   */
+  bool is_consistent() const {
+    const uint64_t n_classes = hashes.size();
+    if (offsets.size() != n_classes + 1 || offsets[0] != 0 ||
+        offsets[n_classes] != arena.size()) {
+      return false;
+    }
+    for (uint64_t class_id = 0; class_id < n_classes; ++class_id) {
+      if (offsets[class_id] > offsets[class_id + 1]) {
+        return false;
+      }
+    }
+    uint64_t n_occupied = 0;
+    for (size_t islot = 0; islot < slots.size(); ++islot) {
+      const uint64_t slot = slots[islot];
+      if (slot == 0) {
+        continue;
+      }
+      const uint64_t id = slot & id_mask;
+      if (id == 0 || id > n_classes) {
+        return false;
+      }
+      ++n_occupied;
+    }
+    return n_occupied == n_classes && n_occupied < slots.size();
+  }
+
+  /**
+   * Returns the class id of \p certificate if present. Otherwise, returns
+   * std::nullopt and stores in \p islot the empty slot where it belongs.
+   */
+  std::optional<uint64_t> find_slot(const std::string &certificate,
+                                    const Hash128 &hash, size_t &islot) const {
+    const size_t mask = slots.size() - 1;
+    const uint64_t tag = tag_of(hash.lo);
+    for (islot = hash.lo & mask;; islot = (islot + 1) & mask) {
+      const uint64_t slot = slots[islot];
+      if (slot == 0) {
+        return std::nullopt;
+      }
+      if ((slot >> id_bits) != tag) {
+        continue;
+      }
+      const uint64_t class_id = (slot & id_mask) - 1;
+      const uint64_t begin = offsets[class_id], end = offsets[class_id + 1];
+      if (end - begin == certificate.size() &&
+          std::memcmp(arena.data() + begin, certificate.data(),
+                      certificate.size()) == 0) {
+        return class_id;
+      }
+    }
+  }
+
+  std::pair<uint64_t, bool> insert_locked(const std::string &certificate,
+                                          const Hash128 &hash) {
+    size_t islot;
+    if (std::optional<uint64_t> class_id =
+            find_slot(certificate, hash, islot)) {
+      return {*class_id, false};
+    }
+
+    const uint64_t class_id = hashes.size();
+    if (class_id + 1 > id_mask) {
+      throw std::runtime_error("Canonical index is full.");
+    }
+    arena.append(certificate.data(), certificate.size());
+    offsets.push_back(arena.size());
+    hashes.push_back(hash.lo);
+    // Keep the load factor at most 3/4.
+    if (4 * (class_id + 1) > 3 * slots.size()) {
+      rehash(2 * slots.size());
+    } else {
+      slots.set(islot, (tag_of(hash.lo) << id_bits) | (class_id + 1));
+    }
+    return {class_id, true};
+  }
+
+  void rehash(size_t n_slots) {
+    const size_t mask = n_slots - 1;
+    std::vector<uint64_t> new_slots(n_slots, 0);
+    for (uint64_t class_id = 0; class_id < hashes.size(); ++class_id) {
+      size_t islot = hashes[class_id] & mask;
+      while (new_slots[islot] != 0) {
+        islot = (islot + 1) & mask;
+      }
+      new_slots[islot] = (tag_of(hashes[class_id]) << id_bits) | (class_id + 1);
+    }
+    slots.replace(std::move(new_slots));
+  }
+
+  template <typename T>
+  static bool write_column(FILE *fp, const Column<T> &column) {
+    return column.size() == 0 ||
+           std::fwrite(column.data(), sizeof(T), column.size(), fp) ==
+               column.size();
+  }
+};
+
+// }}}
+
+// {{{ bindings
+
+/**
+ * Canonicalizes \p g and stores its certificate and the certificate's hash.
+ * Runs without the GIL.
+ */
+template <typename GraphT>
+static void compute_certificate(GraphT &g, std::string &certificate,
+                                Hash128 &hash) {
+  Stats stats;
+  const unsigned int *perm = g.canonical_form(stats);
+  certificate = make_certificate(g, perm);
+  hash = murmur3_128(certificate.data(), certificate.size());
+}
+
+static std::string path_to_str(nb::object path) {
+  nb::module_ os = nb::module_::import_("os");
+  nb::bytes encoded = nb::borrow<nb::bytes>(os.attr("fsencode")(path));
+  return std::string(encoded.c_str(), encoded.size());
+}
+
+static const char *insert_doc =
+    "Returns ``(class_id, is_new)``, where *class_id* is the id of the "
+    "isomorphism class of *graph* and *is_new* tells whether the class was "
+    "added to the index by this call.";
+
+static const char *insert_many_doc =
+    "Inserts every graph of *graphs* as :meth:`insert` would, in order, and "
+    "returns the results as a ``uint64`` :class:`numpy.ndarray` of class ids "
+    "and a ``bool`` :class:`numpy.ndarray` of *is_new* flags. The graphs are "
+    "canonicalized on *n_threads* native threads (one per hardware thread "
+    "by default), as in :func:`pybliss.canonicalize_many`. The class ids do "
+    "not depend on the number of threads.";
+
+static const char *class_id_doc =
+    "Returns the id of the isomorphism class of *graph*, or *None* if the "
+    "index does not contain it.";
+
+static const char *contains_doc =
+    "Returns *True* if and only if the index contains the isomorphism class "
+    "of *graph*. Also available as ``graph in index``.";
+
+/**
+ * Binds the methods of CanonicalIndex taking a \p GraphT. The docstrings
+ * are attached to the :class:`Graph` overloads only, as they describe both.
+ */
+template <typename GraphT>
+static void bind_index_methods(nb::class_<CanonicalIndex> &index) {
+  const bool is_documented = std::is_same<GraphT, Graph>::value;
+  index.def(
+      "insert",
+      [](CanonicalIndex &self, GraphT &g) {
+        nb::gil_scoped_release release;
+        std::string certificate;
+        Hash128 hash;
+        compute_certificate(g, certificate, hash);
+        return self.insert(certificate, hash);
+      },
+      "graph"_a, is_documented ? insert_doc : "");
+  index.def(
+      "insert_many",
+      [](CanonicalIndex &self, const std::vector<GraphT *> &graphs,
+         unsigned int n_threads) {
+        const size_t n_graphs = graphs.size();
+        for (GraphT *g : graphs) {
+          if (!g) {
+            throw std::runtime_error("Entries of 'graphs' cannot be None.");
+          }
+        }
+        std::vector<size_t> first_occurrence;
+        const std::vector<size_t> unique_ids =
+            find_first_occurrences(graphs, first_occurrence);
+
+        std::vector<std::string> certificates(n_graphs);
+        std::vector<Hash128> hashes(n_graphs);
+        std::unique_ptr<uint64_t[]> class_ids(new uint64_t[n_graphs]);
+        std::unique_ptr<bool[]> is_new(new bool[n_graphs]);
+        {
+          nb::gil_scoped_release release;
+          parallel_for(unique_ids.size(), n_threads,
+                       [&](size_t i, unsigned int) {
+                         const size_t igraph = unique_ids[i];
+                         compute_certificate(*graphs[igraph],
+                                             certificates[igraph],
+                                             hashes[igraph]);
+                       });
+          for (size_t i = 0; i < n_graphs; ++i) {
+            if (first_occurrence[i] != i) {
+              certificates[i] = certificates[first_occurrence[i]];
+              hashes[i] = hashes[first_occurrence[i]];
+            }
+          }
+          self.insert_many(certificates.data(), hashes.data(), n_graphs,
+                           class_ids.get(), is_new.get());
+        }
+        return nb::make_tuple(
+            make_owned_ndarray(class_ids.release(), {n_graphs}),
+            make_owned_ndarray(is_new.release(), {n_graphs}));
+      },
+      "graphs"_a, "n_threads"_a = 0, is_documented ? insert_many_doc : "");
+  index.def(
+      "class_id",
+      [](const CanonicalIndex &self, GraphT &g) {
+        nb::gil_scoped_release release;
+        std::string certificate;
+        Hash128 hash;
+        compute_certificate(g, certificate, hash);
+        return self.find(certificate, hash);
+      },
+      "graph"_a, is_documented ? class_id_doc : "");
+  auto contains = [](const CanonicalIndex &self, GraphT &g) {
+    nb::gil_scoped_release release;
+    std::string certificate;
+    Hash128 hash;
+    compute_certificate(g, certificate, hash);
+    return self.find(certificate, hash).has_value();
+  };
+  index.def("contains", contains, "graph"_a,
+            is_documented ? contains_doc : "");
+  index.def("__contains__", contains, "graph"_a);
+}
+
+void bind_canonical_index(nb::module_ &m) {
+  nb::class_<CanonicalIndex> index(m, "CanonicalIndex", R"(
+    A set of graphs up to isomorphism, meant for deduplicating large streams
+    of graphs. Inserted :class:`Graph` and :class:`Digraph` objects are
+    canonicalized and only the compact certificates of their canonical forms
+    (see :meth:`Graph.canonical_certificate`) are stored, in an
+    open-addressing hash table. Every isomorphism class is assigned an
+    integer id, in the order the classes were first inserted. Graphs and
+    digraphs form distinct classes.
+
+    The graphs are canonicalized with their own settings (see
+    :meth:`Graph.set_splitting_heuristic` and
+    :meth:`Graph.set_component_recursion`), which must therefore be the same
+    for all the graphs of an index. Canonicalizing modifies the search state
+    of a graph object, so a graph must not be used by another thread while
+    it is being inserted or looked up.
+
+    All methods release the GIL and may be called concurrently from
+    several threads: lookups proceed in parallel while insertions are
+    serialized.
+
+    .. automethod:: __init__
+    .. automethod:: insert
+    .. automethod:: insert_many
+    .. automethod:: contains
+    .. automethod:: class_id
+    .. automethod:: certificate
+    .. automethod:: __len__
+    .. automethod:: save
+    .. automethod:: load
+  )");
+  index.def(nb::init<>(), "Creates an empty index.");
+  bind_index_methods<Graph>(index);
+  bind_index_methods<Digraph>(index);
+
+  index.def(
+      "certificate",
+      [](const CanonicalIndex &self, uint64_t class_id) {
+        const std::string certificate = self.certificate(class_id);
+        return nb::bytes(certificate.data(), certificate.size());
+      },
+      "class_id"_a,
+      "Returns the certificate, as returned by "
+      ":meth:`Graph.canonical_certificate`, of the class *class_id*.");
+  index.def("__len__", &CanonicalIndex::size,
+            "Returns the number of isomorphism classes in the index.");
+  index.def(
+      "save",
+      [](const CanonicalIndex &self, nb::object path) {
+        const std::string p = path_to_str(path);
+        nb::gil_scoped_release release;
+        self.save(p.c_str());
+      },
+      "path"_a,
+      "Writes the index to the file at *path*, see :meth:`load`. The file "
+      "uses the native byte order.");
+  index.def_static(
+      "load",
+      [](nb::object path) {
+        const std::string p = path_to_str(path);
+        nb::gil_scoped_release release;
+        return CanonicalIndex::load(p.c_str());
+      },
+      "path"_a,
+      "Returns the index saved in the file at *path* by :meth:`save`. The "
+      "file is memory-mapped rather than read: opening it only checks the "
+      "hash table and the certificate offsets, and lookups only touch the "
+      "certificates they compare. Raises :class:`RuntimeError` if the file "
+      "is truncated or inconsistent. The index can be extended, in which "
+      "case the modified parts are copied to memory first; the file itself "
+      "is never modified.");
+}
+
+// }}}
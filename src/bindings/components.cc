@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <nanobind/nanobind.h>
+#include <numeric>
+#include <pybliss_certificate.h>
+#include <pybliss_components.h>
+#include <pybliss_ext.h>
+#include <pybliss_graph_access.h>
+
+using namespace bliss;
+
+/**
+ * Returns the (weakly) connected components of \p g as sorted lists of
+ * vertices, ordered by their smallest vertex.
+ */
+template <typename GraphT>
+static std::vector<std::vector<uint32_t>> connected_components(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  const auto &vs = Access::vertices_of(g);
+  const uint32_t nvertices = vs.size();
+  std::vector<bool> seen(nvertices, false);
+  std::vector<std::vector<uint32_t>> components;
+  for (uint32_t root = 0; root < nvertices; ++root) {
+    if (seen[root]) {
+      continue;
+    }
+    std::vector<uint32_t> component = {root};
+    seen[root] = true;
+    for (size_t i = 0; i < component.size(); ++i) {
+      auto visit = [&](const std::vector<unsigned int> &neighbors) {
+        for (unsigned int w : neighbors) {
+          if (!seen[w]) {
+            seen[w] = true;
+            component.push_back(w);
+          }
+        }
+      };
+      visit(Access::out_edges(vs[component[i]]));
+      if constexpr (Access::is_directed) {
+        visit(vs[component[i]].edges_in);
+      }
+    }
+    std::sort(component.begin(), component.end());
+    components.push_back(std::move(component));
+  }
+  return components;
+}
+
+/**
+ * Returns the subgraph of \p g induced by \p component, its sorted
+ * vertices, whose i-th vertex becomes vertex i. \p local must map every
+ * vertex of the component to its index in \p component.
+ */
+template <typename GraphT>
+static std::unique_ptr<GraphT>
+induced_subgraph(GraphT &g, const std::vector<uint32_t> &component,
+                 const std::vector<uint32_t> &local) {
+  using Access = GraphAccess<GraphT>;
+  const auto &vs = Access::vertices_of(g);
+  auto sub = std::make_unique<GraphT>(component.size());
+  auto &sub_vs = Access::vertices_of(*sub);
+  for (size_t i = 0; i < component.size(); ++i) {
+    const auto &vertex = vs[component[i]];
+    sub_vs[i].color = vertex.color;
+    // The vertices keep their relative order, so the lists stay sorted.
+    auto relabel = [&](const std::vector<unsigned int> &from,
+                       std::vector<unsigned int> &to) {
+      to.reserve(from.size());
+      for (unsigned int w : from) {
+        to.push_back(local[w]);
+      }
+    };
+    if constexpr (Access::is_directed) {
+      relabel(vertex.edges_out, sub_vs[i].edges_out);
+      relabel(vertex.edges_in, sub_vs[i].edges_in);
+    } else {
+      relabel(vertex.edges, sub_vs[i].edges);
+    }
+  }
+  Access::copy_search_options(g, *sub);
+  return sub;
+}
+
+template <typename GraphT>
+std::vector<uint32_t> canonical_labeling_by_components(GraphT &g,
+                                                       ComponentCache *cache) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const uint32_t nvertices = g.get_nof_vertices();
+  const auto components = connected_components(g);
+  const auto options = Access::get_search_options(g);
+
+  // Canonical labelings depend on the graph type and on every search
+  // option, which prefix the cache keys.
+  std::string key_prefix;
+  append_varint(key_prefix, Access::is_directed ? 1 : 0);
+  append_varint(key_prefix, options.splitting_heuristic);
+  append_varint(key_prefix, options.flags());
+
+  std::vector<std::shared_ptr<const ComponentCache::Entry>> entries;
+  std::vector<uint32_t> local(nvertices), identity;
+  CertificateScratch scratch;
+  std::string key;
+  for (const std::vector<uint32_t> &component : components) {
+    for (uint32_t i = 0; i < component.size(); ++i) {
+      local[component[i]] = i;
+    }
+    auto sub = induced_subgraph(g, component, local);
+    if (identity.size() < component.size()) {
+      identity.resize(component.size());
+      std::iota(identity.begin(), identity.end(), 0);
+    }
+    make_certificate(*sub, identity.data(), scratch, key);
+
+    if (component.size() == 1) {
+      // A single vertex is its own canonical form.
+      entries.push_back(std::make_shared<ComponentCache::Entry>(
+          ComponentCache::Entry{{0}, key}));
+      continue;
+    }
+    key.insert(0, key_prefix);
+    std::shared_ptr<const ComponentCache::Entry> entry =
+        cache ? cache->find(key) : nullptr;
+    if (!entry) {
+      Stats stats;
+      const unsigned int *perm = sub->canonical_form(stats);
+      auto computed = std::make_shared<ComponentCache::Entry>();
+      computed->labeling.assign(perm, perm + component.size());
+      make_certificate(*sub, perm, scratch, computed->certificate);
+      entry = std::move(computed);
+      if (cache) {
+        cache->insert(key, entry);
+      }
+    }
+    entries.push_back(std::move(entry));
+  }
+
+  // Isomorphic components have equal certificates and may come in any
+  // order, the smallest vertex only makes the order deterministic.
+  std::vector<size_t> order(components.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    const std::string &ca = entries[a]->certificate;
+    const std::string &cb = entries[b]->certificate;
+    if (ca.size() != cb.size()) {
+      return ca.size() < cb.size();
+    }
+    return ca != cb ? ca < cb : a < b;
+  });
+
+  std::vector<uint32_t> labeling(nvertices);
+  uint32_t offset = 0;
+  for (size_t icomponent : order) {
+    const std::vector<uint32_t> &component = components[icomponent];
+    const std::vector<uint32_t> &component_labeling =
+        entries[icomponent]->labeling;
+    for (size_t i = 0; i < component.size(); ++i) {
+      labeling[component[i]] = offset + component_labeling[i];
+    }
+    offset += component.size();
+  }
+  return labeling;
+}
+
+template std::vector<uint32_t>
+canonical_labeling_by_components<Graph>(Graph &, ComponentCache *);
+template std::vector<uint32_t>
+canonical_labeling_by_components<Digraph>(Digraph &, ComponentCache *);
+
+void bind_component_cache(nb::module_ &m) {
+  nb::class_<ComponentCache>(
+      m, "ComponentCache",
+      "A least-recently-used cache of the canonical labelings of connected "
+      "components, passed as the *cache* argument of "
+      ":meth:`Graph.canonical_labeling_by_components`. A component is "
+      "canonicalized once for as long as it stays in the cache, across "
+      "graphs and calls, as long as it recurs with the same vertex order, "
+      "adjacency and colors, and the same search options: the splitting "
+      "heuristic, failure recording, component recursion and long prune "
+      "settings all take part in the cache keys. A cache may be "
+      "shared by :class:`Graph` and :class:`Digraph` searches running on "
+      "several threads.\n\n"
+      ".. automethod:: __init__\n"
+      ".. autoattribute:: size\n"
+      ".. autoattribute:: max_size\n"
+      ".. autoattribute:: hits\n"
+      ".. autoattribute:: misses\n"
+      ".. automethod:: clear")
+      .def(nb::init<size_t>(), "max_size"_a = 4096,
+           "Creates an empty cache holding at most *max_size* components.")
+      .def_prop_ro("size", &ComponentCache::size,
+                   "The number of components in the cache.")
+      .def_prop_ro("max_size", &ComponentCache::get_max_size,
+                   "The maximal number of components in the cache.")
+      .def_prop_ro("hits", &ComponentCache::get_hits,
+                   "The number of components found in the cache.")
+      .def_prop_ro("misses", &ComponentCache::get_misses,
+                   "The number of components that had to be searched.")
+      .def("clear", &ComponentCache::clear,
+           "Empties the cache and resets its counters.");
+}
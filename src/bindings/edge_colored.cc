@@ -0,0 +1,575 @@
+#include <algorithm>
+#include <array>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/function.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/string.h>
+#include <numeric>
+#include <optional>
+#include <pybliss_certificate.h>
+#include <pybliss_ext.h>
+#include <pybliss_graph_access.h>
+#include <pybliss_search.h>
+#include <string>
+#include <vector>
+
+using namespace bliss;
+
+using ColoredEdgeArray = nb::ndarray<const uint32_t, nb::ndim<2>, nb::c_contig>;
+using VertexColorArray = nb::ndarray<const uint32_t, nb::ndim<1>, nb::c_contig>;
+
+enum class EdgeColorEncoding { layered, subdivision };
+
+/**
+ * Returns the position of \p key in \p keys, which is sorted and holds it.
+ */
+static uint32_t rank_of(const std::vector<std::vector<uint32_t>> &keys,
+                        const std::vector<uint32_t> &key) {
+  return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+/**
+ * A graph with colored vertices and colored, possibly parallel, edges,
+ * searched by bliss through an encoding as a vertex-colored \p GraphT.
+ *
+ * The parallel edges between two vertices are merged into one edge whose
+ * color is the sorted list of their colors, and the self-loops of a vertex
+ * are merged into its color likewise. The distinct merged colors are then
+ * numbered in sorted order, which only depends on the isomorphism class of
+ * the graph. The encoding is either
+ *
+ * - layered: with b the bit length of the largest edge color number (which
+ *   starts at 1), vertex v becomes the b vertices l * N + v, one per layer
+ *   l, joined by a path through the layers. An edge of color number c
+ *   becomes an edge in every layer l whose bit l is set in c. The layers
+ *   are told apart by the vertex colors.
+ * - subdivision: every edge becomes a vertex N + i, colored after the edge
+ *   color and joined to the endpoints of the edge (from the source and to
+ *   the target for a Digraph).
+ *
+ * In both, the original vertices are the first N vertices and have the
+ * smallest colors, so that the automorphisms and canonical labelings of the
+ * encoding restrict to those of the graph.
+ */
+template <typename GraphT> class EdgeColoredGraph {
+public:
+  using Access = GraphAccess<GraphT>;
+
+  /**
+   * \p edges holds a (u, v, color) triple per edge and \p colors a color per
+   * vertex, or is empty if all vertices have color 0. \p encoding is
+   * "layered", "subdivision" or "auto" to pick the encoding with the
+   * fewest vertices and edges. May be called without the GIL.
+   */
+  EdgeColoredGraph(uint32_t nvertices, std::vector<uint32_t> edges,
+                   std::vector<uint32_t> colors, const std::string &encoding)
+      : nvertices(nvertices), edges(std::move(edges)),
+        colors(std::move(colors)) {
+    if (this->colors.empty()) {
+      this->colors.assign(nvertices, 0);
+    }
+    for (size_t i = 0; i < this->edges.size(); i += 3) {
+      if (this->edges[i] >= nvertices || this->edges[i + 1] >= nvertices) {
+        throw std::runtime_error(
+            "'edges' must use 0-based labeling of the vertices.");
+      }
+    }
+    if (encoding != "auto" && encoding != "layered" &&
+        encoding != "subdivision") {
+      throw std::runtime_error(
+          "'encoding' must be 'auto', 'layered' or 'subdivision'.");
+    }
+    encode(encoding);
+  }
+
+  uint32_t get_nof_vertices() const { return nvertices; }
+  size_t get_nof_edges() const { return edges.size() / 3; }
+  const std::vector<uint32_t> &get_edges() const { return edges; }
+  const std::vector<uint32_t> &get_colors() const { return colors; }
+  EdgeColorEncoding get_encoding() const { return encoding; }
+  GraphT &get_encoded() const { return *encoded; }
+
+  /**
+   * Returns the edges as sorted (u, v, color) triples, with u <= v for a
+   * Graph, every edge being mapped through \p perm if not null.
+   */
+  std::vector<std::array<uint32_t, 3>>
+  sorted_edges(const uint32_t *perm = nullptr) const {
+    std::vector<std::array<uint32_t, 3>> result(get_nof_edges());
+    for (size_t i = 0; i < result.size(); ++i) {
+      uint32_t u = edges[3 * i], v = edges[3 * i + 1];
+      if (perm) {
+        u = perm[u];
+        v = perm[v];
+      }
+      if (!Access::is_directed && u > v) {
+        std::swap(u, v);
+      }
+      result[i] = {u, v, edges[3 * i + 2]};
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  /**
+   * Returns true if \p perm, a permutation of the vertices, maps every
+   * vertex to one of the same color and the edges onto the edges, with
+   * their colors and multiplicities.
+   */
+  bool is_automorphism(const uint32_t *perm) const {
+    for (uint32_t v = 0; v < nvertices; ++v) {
+      if (colors[perm[v]] != colors[v]) {
+        return false;
+      }
+    }
+    return sorted_edges(perm) == sorted_edges();
+  }
+
+  /**
+   * Returns the graph obtained by relabeling every vertex v as \p perm[v],
+   * encoded the same way.
+   */
+  std::unique_ptr<EdgeColoredGraph> permute(const uint32_t *perm) const {
+    std::vector<uint32_t> permuted_edges(edges);
+    std::vector<uint32_t> permuted_colors(nvertices);
+    for (size_t i = 0; i < permuted_edges.size(); i += 3) {
+      permuted_edges[i] = perm[edges[i]];
+      permuted_edges[i + 1] = perm[edges[i + 1]];
+    }
+    for (uint32_t v = 0; v < nvertices; ++v) {
+      permuted_colors[perm[v]] = colors[v];
+    }
+    return std::make_unique<EdgeColoredGraph>(
+        nvertices, std::move(permuted_edges), std::move(permuted_colors),
+        encoding == EdgeColorEncoding::layered ? "layered" : "subdivision");
+  }
+
+  /**
+   * Returns the canonical labeling of the graph given \p perm, the
+   * canonical labeling of its encoding. The original vertices come first in
+   * the canonical order of the encoding, their relative order is kept
+   * regardless.
+   */
+  std::vector<uint32_t> restrict_labeling(const unsigned int *perm) const {
+    std::vector<uint32_t> order(nvertices), labeling(nvertices);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(),
+              [perm](uint32_t v, uint32_t w) { return perm[v] < perm[w]; });
+    for (uint32_t i = 0; i < nvertices; ++i) {
+      labeling[order[i]] = i;
+    }
+    return labeling;
+  }
+
+  /**
+   * Stores in \p out the certificate of the graph relabeled by \p perm: a
+   * sequence of LEB128 varints made of a tag (2 for an EdgeColoredGraph, 3
+   * for an EdgeColoredDigraph), N, the N vertex colors, the number of
+   * edges, and the sorted (u, v, color) triples of the edges.
+   */
+  void make_certificate(const uint32_t *perm, std::string &out) const {
+    std::vector<uint32_t> permuted_colors(nvertices);
+    for (uint32_t v = 0; v < nvertices; ++v) {
+      permuted_colors[perm[v]] = colors[v];
+    }
+    out.clear();
+    append_varint(out, Access::is_directed ? 3 : 2);
+    append_varint(out, nvertices);
+    for (uint32_t color : permuted_colors) {
+      append_varint(out, color);
+    }
+    const auto permuted_edges = sorted_edges(perm);
+    append_varint(out, permuted_edges.size());
+    for (const auto &edge : permuted_edges) {
+      for (uint32_t x : edge) {
+        append_varint(out, x);
+      }
+    }
+  }
+
+private:
+  void encode(const std::string &requested) {
+    // Merge the parallel edges and the self-loops.
+    const auto triples = sorted_edges();
+    std::vector<std::vector<uint32_t>> vertex_keys(nvertices);
+    for (uint32_t v = 0; v < nvertices; ++v) {
+      vertex_keys[v] = {colors[v]};
+    }
+    std::vector<uint32_t> pairs;
+    std::vector<std::vector<uint32_t>> pair_keys;
+    for (size_t i = 0; i < triples.size(); ++i) {
+      const auto &[u, v, color] = triples[i];
+      if (u == v) {
+        vertex_keys[u].push_back(color);
+      } else if (i > 0 && triples[i - 1][0] == u && triples[i - 1][1] == v) {
+        pair_keys.back().push_back(color);
+      } else {
+        pairs.push_back(u);
+        pairs.push_back(v);
+        pair_keys.push_back({color});
+      }
+    }
+    const size_t npairs = pair_keys.size();
+
+    auto sorted_unique = [](std::vector<std::vector<uint32_t>> keys) {
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      return keys;
+    };
+    const auto vertex_classes = sorted_unique(vertex_keys);
+    const auto edge_classes = sorted_unique(pair_keys);
+    const uint64_t nvertex_classes = vertex_classes.size();
+    std::vector<uint32_t> edge_codes(npairs);
+    uint64_t nbits_set = 0;
+    for (size_t i = 0; i < npairs; ++i) {
+      edge_codes[i] = rank_of(edge_classes, pair_keys[i]) + 1;
+      for (uint32_t code = edge_codes[i]; code; code >>= 1) {
+        nbits_set += code & 1;
+      }
+    }
+    uint32_t nlayers = 1;
+    while ((uint64_t)1 << nlayers <= edge_classes.size()) {
+      ++nlayers;
+    }
+
+    // The cost of a search grows with the size of the graph searched.
+    const uint64_t layered_cost =
+        (uint64_t)nvertices * (2 * nlayers - 1) + nbits_set;
+    const uint64_t subdivision_cost = (uint64_t)nvertices + 3 * npairs;
+    if (requested == "layered") {
+      encoding = EdgeColorEncoding::layered;
+    } else if (requested == "subdivision") {
+      encoding = EdgeColorEncoding::subdivision;
+    } else {
+      encoding = layered_cost <= subdivision_cost
+                     ? EdgeColorEncoding::layered
+                     : EdgeColorEncoding::subdivision;
+    }
+
+    const uint64_t nencoded = encoding == EdgeColorEncoding::layered
+                                  ? (uint64_t)nvertices * nlayers
+                                  : (uint64_t)nvertices + npairs;
+    const uint64_t max_color = encoding == EdgeColorEncoding::layered
+                                   ? nvertex_classes * nlayers
+                                   : nvertex_classes + edge_classes.size();
+    if (nencoded > std::numeric_limits<unsigned int>::max() ||
+        max_color > std::numeric_limits<unsigned int>::max()) {
+      throw std::runtime_error(
+          "The encoded graph has too many vertices or colors.");
+    }
+
+    std::vector<uint32_t> encoded_colors(nencoded), encoded_edges;
+    for (uint32_t v = 0; v < nvertices; ++v) {
+      encoded_colors[v] = rank_of(vertex_classes, vertex_keys[v]);
+    }
+    if (encoding == EdgeColorEncoding::layered) {
+      encoded_edges.reserve(2 * (nvertices * (nlayers - 1) + nbits_set));
+      for (uint32_t l = 1; l < nlayers; ++l) {
+        for (uint32_t v = 0; v < nvertices; ++v) {
+          const uint32_t below = (l - 1) * nvertices + v;
+          encoded_colors[below + nvertices] =
+              l * nvertex_classes + encoded_colors[v];
+          encoded_edges.push_back(below);
+          encoded_edges.push_back(below + nvertices);
+        }
+      }
+      for (size_t i = 0; i < npairs; ++i) {
+        for (uint32_t l = 0; l < nlayers; ++l) {
+          if (edge_codes[i] >> l & 1) {
+            encoded_edges.push_back(l * nvertices + pairs[2 * i]);
+            encoded_edges.push_back(l * nvertices + pairs[2 * i + 1]);
+          }
+        }
+      }
+    } else {
+      encoded_edges.reserve(4 * npairs);
+      for (size_t i = 0; i < npairs; ++i) {
+        const uint32_t e = nvertices + i;
+        encoded_colors[e] = nvertex_classes + edge_codes[i] - 1;
+        encoded_edges.insert(encoded_edges.end(),
+                             {pairs[2 * i], e, e, pairs[2 * i + 1]});
+      }
+    }
+
+    encoded = std::make_unique<GraphT>(nencoded);
+    Access::set_colors(*encoded, encoded_colors.data());
+    Access::add_edges(*encoded, encoded_edges.data(),
+                      encoded_edges.size() / 2);
+    Access::normalize(*encoded);
+  }
+
+  uint32_t nvertices;
+  std::vector<uint32_t> edges;
+  std::vector<uint32_t> colors;
+  EdgeColorEncoding encoding;
+  std::unique_ptr<GraphT> encoded;
+};
+
+/**
+ * Returns the data of \p ary after checking that it is a permutation of the
+ * \p nvertices vertices.
+ */
+static const uint32_t *
+checked_permutation(const nb::ndarray<uint32_t, nb::ndim<1>> &ary,
+                    uint32_t nvertices) {
+  perform_sanity_checks_on_perm_array(ary, nvertices);
+  const uint32_t *perm = (const uint32_t *)ary.data();
+  std::vector<bool> seen(nvertices, false);
+  for (uint32_t v = 0; v < nvertices; ++v) {
+    if (perm[v] >= nvertices || seen[perm[v]]) {
+      throw std::runtime_error("'perm' must be a permutation of the "
+                               "vertices.");
+    }
+    seen[perm[v]] = true;
+  }
+  return perm;
+}
+
+template <typename GraphT>
+static void bind_edge_colored_graph(nb::module_ &m, const char *name) {
+  using ECGraph = EdgeColoredGraph<GraphT>;
+  nb::class_<ECGraph> graph(
+      m, name,
+      "A graph with colored vertices and colored edges, which may have "
+      "parallel edges and self-loops. bliss only supports vertex colors: "
+      "the graph is searched through an equivalent vertex-colored "
+      ":class:`Graph` (for :class:`EdgeColoredGraph`) or :class:`Digraph` "
+      "(for :class:`EdgeColoredDigraph`) that is built natively when the "
+      "graph is created, and the automorphisms and canonical labelings found "
+      "are mapped back to the vertices of this graph.\n\n"
+      "The edges between two vertices are merged into one edge whose color "
+      "is the sorted list of their colors, and the self-loops of a vertex "
+      "are merged into its color likewise. The distinct merged edge colors "
+      "are numbered from 1 and encoded in one of two ways:\n\n"
+      "- ``\"layered\"``: every vertex becomes a path of :math:`b` copies, one "
+      "per layer, :math:`b` being the bit length of the number of distinct "
+      "edge colors, and an edge joins the copies of its endpoints in every "
+      "layer whose bit is set in the number of its color. This takes "
+      ":math:`bN` vertices and suits graphs with few edge colors: with a "
+      "single edge color, the encoding is the graph itself.\n"
+      "- ``\"subdivision\"``: every edge becomes a vertex colored after the "
+      "edge color and joined to the endpoints of the edge. This takes "
+      ":math:`N + m` vertices for :math:`m` merged edges.\n\n"
+      "The searches release the GIL and take the same *stats*, *report* and "
+      "*terminate* arguments as their :class:`Graph` counterparts, *report* "
+      "being called with automorphisms of this graph.\n\n"
+      ".. automethod:: __init__\n"
+      ".. autoattribute:: nvertices\n"
+      ".. autoattribute:: nedges\n"
+      ".. autoattribute:: encoding\n"
+      ".. automethod:: to_edge_array\n"
+      ".. automethod:: to_encoded_graph\n"
+      ".. automethod:: permute\n"
+      ".. automethod:: is_automorphism\n"
+      ".. automethod:: find_automorphisms\n"
+      ".. automethod:: automorphism_generators\n"
+      ".. automethod:: get_permutation_to_canonical_form\n"
+      ".. automethod:: canonical_certificate\n"
+      ".. automethod:: __eq__");
+  graph.def(
+      "__init__",
+      [](ECGraph *self, uint32_t nvertices, const ColoredEdgeArray &edges,
+         const std::optional<VertexColorArray> &colors,
+         const std::string &encoding) {
+        if (edges.shape(1) != 3) {
+          throw std::runtime_error("'edges' must be of shape (m, 3).");
+        }
+        if (colors && colors->shape(0) != nvertices) {
+          throw std::runtime_error(
+              "Color array must have an entry for every vertex of the graph.");
+        }
+        const uint32_t *edge_data = (const uint32_t *)edges.data();
+        std::vector<uint32_t> edge_vector(edge_data,
+                                          edge_data + 3 * edges.shape(0));
+        std::vector<uint32_t> color_vector;
+        if (colors) {
+          const uint32_t *color_data = (const uint32_t *)colors->data();
+          color_vector.assign(color_data, color_data + nvertices);
+        }
+        nb::gil_scoped_release release;
+        new (self) ECGraph(nvertices, std::move(edge_vector),
+                           std::move(color_vector), encoding);
+      },
+      "nvertices"_a, "edges"_a, "colors"_a = nb::none(),
+      "encoding"_a = "auto",
+      "Creates a graph with *nvertices* vertices and an edge for every row "
+      "``[u, v, color]`` of *edges*, a C-contiguous ``uint32`` array of "
+      "shape :math:`(m, 3)`. The vertex colors are *colors*, an N-long "
+      "``uint32`` array (all 0 if not given).\n\n"
+      ":arg encoding: ``\"layered\"``, ``\"subdivision\"`` or ``\"auto\"`` "
+      "for the encoding with the fewest vertices and edges. Canonical "
+      "labelings are only comparable between graphs using the same "
+      "encoding, which ``\"auto\"`` guarantees for isomorphic graphs.");
+  graph.def_prop_ro("nvertices", &ECGraph::get_nof_vertices,
+                    "Return the number of vertices in the graph.");
+  graph.def_prop_ro("nedges", &ECGraph::get_nof_edges,
+                    "Return the number of edges in the graph, counting "
+                    "parallel edges and self-loops.");
+  graph.def_prop_ro(
+      "encoding",
+      [](const ECGraph &self) {
+        return self.get_encoding() == EdgeColorEncoding::layered
+                   ? "layered"
+                   : "subdivision";
+      },
+      "The encoding used for the searches, ``\"layered\"`` or "
+      "``\"subdivision\"``.");
+  graph.def(
+      "to_edge_array",
+      [](const ECGraph &self) {
+        std::vector<uint32_t> edges(self.get_edges());
+        std::vector<uint32_t> colors(self.get_colors());
+        const size_t nedges = self.get_nof_edges();
+        const size_t nvertices = self.get_nof_vertices();
+        return nb::make_tuple(make_owned_ndarray(std::move(edges), {nedges, 3}),
+                              make_owned_ndarray(std::move(colors),
+                                                 {nvertices}));
+      },
+      "Returns ``(edges, colors)``, the ``uint32`` arrays of shapes "
+      ":math:`(m, 3)` and :math:`(N,)` the graph was created from.");
+  graph.def(
+      "to_encoded_graph",
+      [](const ECGraph &self) { return self.get_encoded().copy(); },
+      "Returns a copy of the vertex-colored graph searched by bliss. Its "
+      "first N vertices are the vertices of this graph, in the same order.");
+  graph.def(
+      "permute",
+      [](const ECGraph &self, const nb::ndarray<uint32_t, nb::ndim<1>> &ary) {
+        const uint32_t *perm =
+            checked_permutation(ary, self.get_nof_vertices());
+        nb::gil_scoped_release release;
+        return self.permute(perm).release();
+      },
+      "perm"_a,
+      "Returns a new graph, using the same encoding, in which every vertex "
+      "``v`` of this graph is relabeled ``perm[v]``. *perm* must be a "
+      "permutation of the vertices.");
+  graph.def(
+      "is_automorphism",
+      [](const ECGraph &self, const nb::ndarray<uint32_t, nb::ndim<1>> &ary) {
+        const uint32_t *perm =
+            checked_permutation(ary, self.get_nof_vertices());
+        nb::gil_scoped_release release;
+        return self.is_automorphism(perm);
+      },
+      "perm"_a,
+      "Return true only if *perm*, a permutation of the vertices, preserves "
+      "the vertex colors and maps the edges onto the edges, with their "
+      "colors and multiplicities.");
+  graph.def(
+      "find_automorphisms",
+      [](const ECGraph &self, PyStats &stats,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate) {
+        const SearchLimits limits;
+        SearchMonitor monitor(
+            limits, stats,
+            wrap_py_report(py_report, self.get_nof_vertices()),
+            wrap_py_terminate(py_terminate));
+        nb::gil_scoped_release release;
+        self.get_encoded().find_automorphisms(stats, monitor.report(),
+                                              monitor.terminate());
+      },
+      "stats"_a, "report"_a = nb::none(), "terminate"_a = nb::none(),
+      "Find a set of generators for the automorphism group of the graph, "
+      "reporting each to *report* (if not None) as a read-only N-long "
+      ":class:`numpy.ndarray`. The group of the encoding is that of the "
+      "graph, so the group size in *stats* is that of the graph.");
+  graph.def(
+      "automorphism_generators",
+      [](const ECGraph &self, PyStats &stats) {
+        const size_t nvertices = self.get_nof_vertices();
+        std::vector<uint32_t> generators;
+        const SearchLimits limits;
+        SearchMonitor monitor(
+            limits, stats,
+            [&generators, nvertices](unsigned int, const unsigned int *aut) {
+              generators.insert(generators.end(), aut, aut + nvertices);
+            },
+            nullptr);
+        {
+          nb::gil_scoped_release release;
+          self.get_encoded().find_automorphisms(stats, monitor.report(),
+                                                monitor.terminate());
+        }
+        const size_t ngenerators =
+            nvertices ? generators.size() / nvertices : 0;
+        return make_owned_ndarray(std::move(generators),
+                                  {ngenerators, nvertices});
+      },
+      "stats"_a,
+      "Returns the generators :meth:`find_automorphisms` would report, as a "
+      "C-contiguous ``uint32`` :class:`numpy.ndarray` of shape "
+      ":math:`(k, N)`.");
+  graph.def(
+      "get_permutation_to_canonical_form",
+      [](const ECGraph &self, PyStats &stats,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate) {
+        const SearchLimits limits;
+        SearchMonitor monitor(
+            limits, stats,
+            wrap_py_report(py_report, self.get_nof_vertices()),
+            wrap_py_terminate(py_terminate));
+        std::vector<uint32_t> labeling;
+        {
+          nb::gil_scoped_release release;
+          labeling = self.restrict_labeling(self.get_encoded().canonical_form(
+              stats, monitor.report(), monitor.terminate()));
+        }
+        const size_t nvertices = labeling.size();
+        return make_owned_ndarray(std::move(labeling), {nvertices});
+      },
+      "stats"_a, "report"_a = nb::none(), "terminate"_a = nb::none(),
+      "Returns `P`, a :class:`numpy.ndarray` on {0, ..., N-1} such that "
+      "``self.permute(P)`` is the canonical form of this graph: two graphs "
+      "using the same encoding are isomorphic if and only if their "
+      "canonical forms are equal. `P` is the canonical labeling of the "
+      "encoding restricted to the vertices of this graph.");
+  graph.def(
+      "canonical_certificate",
+      [](const ECGraph &self, PyStats &stats) {
+        const SearchLimits limits;
+        SearchMonitor monitor(limits, stats, nullptr, nullptr);
+        std::string certificate;
+        Hash128 hash;
+        {
+          nb::gil_scoped_release release;
+          const std::vector<uint32_t> labeling =
+              self.restrict_labeling(self.get_encoded().canonical_form(
+                  stats, monitor.report(), monitor.terminate()));
+          self.make_certificate(labeling.data(), certificate);
+          hash = murmur3_128(certificate.data(), certificate.size());
+        }
+        return nb::make_tuple(nb::bytes(certificate.data(), certificate.size()),
+                              uint128_to_int(hash.lo, hash.hi));
+      },
+      "stats"_a,
+      "Returns ``(certificate, hash)`` identifying this graph up to "
+      "isomorphism, as :meth:`Graph.canonical_certificate` does. "
+      "*certificate* encodes the vertex colors and the sorted "
+      "``(u, v, color)`` edges of the canonical form, so two graphs using "
+      "the same encoding are isomorphic if and only if their certificates "
+      "are equal.");
+  graph.def(
+      "__eq__",
+      [](const ECGraph &self, const ECGraph &other) {
+        return self.get_colors() == other.get_colors() &&
+               self.sorted_edges() == other.sorted_edges();
+      },
+      "other"_a,
+      "Return true if both graphs have the same vertex colors and the same "
+      "edges, with their colors and multiplicities.");
+}
+
+void bind_edge_colored_graph(nb::module_ &m) {
+  bind_edge_colored_graph<Graph>(m, "EdgeColoredGraph");
+  bind_edge_colored_graph<Digraph>(m, "EdgeColoredDigraph");
+}
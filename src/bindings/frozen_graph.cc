@@ -0,0 +1,192 @@
+#include <algorithm>
+#include <bliss/graph.hh>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/optional.h>
+#include <optional>
+#include <pybliss_csr.h>
+#include <pybliss_ext.h>
+#include <vector>
+
+using namespace bliss;
+
+/**
+ * An immutable undirected graph whose adjacency lives in borrowed CSR arrays
+ * with sorted rows.
+ */
+class FrozenGraph {
+public:
+  FrozenGraph(IndexArray indptr, IndexArray indices,
+              std::optional<CsrColorArray> colors)
+      : indptr(std::move(indptr)), indices(std::move(indices)),
+        colors(std::move(colors)),
+        csr(csr_from_arrays(this->indptr, this->indices, this->colors)) {
+    nb::gil_scoped_release release;
+    validate_csr(csr, true);
+    if (!csr_is_symmetric(csr)) {
+      throw std::runtime_error(
+          "The adjacency structure of a FrozenGraph must be symmetric.");
+    }
+  }
+
+  const CsrGraph &get_csr() const { return csr; }
+
+  /**
+   * Returns true if \p perm, a permutation of the vertices, maps every vertex
+   * to one of the same color and every edge to an edge.
+   */
+  bool is_automorphism(const uint32_t *perm) const {
+    std::vector<uint32_t> image;
+    for (size_t v = 0; v < csr.nvertices; ++v) {
+      const uint32_t pv = perm[v];
+      if (pv >= csr.nvertices || csr.color(pv) != csr.color(v) ||
+          csr.row_end(pv) - csr.row_begin(pv) !=
+              csr.row_end(v) - csr.row_begin(v)) {
+        return false;
+      }
+      image.clear();
+      for (const uint32_t *w = csr.row_begin(v); w != csr.row_end(v); ++w) {
+        image.push_back(perm[*w]);
+      }
+      std::sort(image.begin(), image.end());
+      if (!std::equal(image.begin(), image.end(), csr.row_begin(pv))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  // Keep the borrowed arrays alive.
+  IndexArray indptr, indices;
+  std::optional<CsrColorArray> colors;
+  CsrGraph csr;
+};
+
+/**
+ * Builds the :class:`Graph` equivalent to \p self, without the GIL, and calls
+ * its method \p name with \p args and \p kwargs. The graph is dropped once
+ * the call returns.
+ */
+static nb::object call_on_graph(const FrozenGraph &self, const char *name,
+                                nb::args args, nb::kwargs kwargs) {
+  std::unique_ptr<Graph> g;
+  {
+    nb::gil_scoped_release release;
+    g = graph_from_csr<Graph>(self.get_csr());
+  }
+  nb::object py_graph = nb::cast(g.release(), nb::rv_policy::take_ownership);
+  return py_graph.attr(name)(*args, **kwargs);
+}
+
+void bind_frozen_graph(nb::module_ &m) {
+  nb::class_<FrozenGraph> frozen_graph(
+      m, "FrozenGraph",
+      "An immutable undirected graph whose adjacency is stored in two flat "
+      "arrays in the compressed sparse row format, as in "
+      ":class:`scipy.sparse.csr_array`. The arrays are borrowed, not copied, "
+      "and must not be modified while the :class:`FrozenGraph` is alive.\n\n"
+      "bliss searches a graph in its own representation, with an adjacency "
+      "list per vertex: the search methods build an equivalent "
+      ":class:`Graph` (as :meth:`Graph.from_csr` would) for the duration of "
+      "the call only, so that the graph only takes the memory of its arrays "
+      "between searches. They accept the same arguments as the "
+      ":class:`Graph` methods of the same name. :meth:`is_automorphism` runs "
+      "on the arrays directly.\n\n"
+      ".. automethod:: __init__\n"
+      ".. autoattribute:: nvertices\n"
+      ".. autoattribute:: nedges\n"
+      ".. automethod:: get_color\n"
+      ".. automethod:: neighbors\n"
+      ".. automethod:: is_automorphism\n"
+      ".. automethod:: to_graph\n"
+      ".. automethod:: find_automorphisms\n"
+      ".. automethod:: automorphism_generators\n"
+      ".. automethod:: orbits\n"
+      ".. automethod:: get_permutation_to_canonical_form\n"
+      ".. automethod:: canonical_certificate\n"
+      ".. automethod:: canonical_labeling_by_components\n"
+      ".. automethod:: refinement_invariant");
+  frozen_graph.def(
+      nb::init<IndexArray, IndexArray, std::optional<CsrColorArray>>(),
+      "indptr"_a, "indices"_a, "colors"_a = nb::none(),
+      "Wraps the graph whose vertex ``i`` has the neighbors "
+      "``indices[indptr[i]:indptr[i+1]]`` and the color ``colors[i]`` (0 if "
+      "*colors* is not given). The arrays are those of "
+      ":meth:`Graph.from_csr`, and the adjacency must be symmetric as "
+      "well. In addition, the rows must be sorted (see "
+      ":meth:`scipy.sparse.csr_array.sort_indices`). Contiguous arrays are "
+      "borrowed, others are copied.");
+  frozen_graph.def_prop_ro(
+      "nvertices",
+      [](const FrozenGraph &self) { return self.get_csr().nvertices; },
+      "Return the number of vertices in the graph.");
+  frozen_graph.def_prop_ro(
+      "nedges",
+      [](const FrozenGraph &self) {
+        const CsrGraph &csr = self.get_csr();
+        size_t nloops = 0;
+        for (uint32_t v = 0; v < csr.nvertices; ++v) {
+          nloops += std::binary_search(csr.row_begin(v), csr.row_end(v), v);
+        }
+        return (csr.nentries + nloops) / 2;
+      },
+      "Return the number of edges in the graph, every self-loop counting as "
+      "one edge.");
+  frozen_graph.def(
+      "get_color",
+      [](const FrozenGraph &self, uint32_t v) {
+        if (v >= self.get_csr().nvertices) {
+          throw nb::index_error("Vertex out of range.");
+        }
+        return self.get_csr().color(v);
+      },
+      "v"_a, "Returns the color of the vertex *v*.");
+  frozen_graph.def(
+      "neighbors",
+      [](nb::handle self, uint32_t v) {
+        const CsrGraph &csr = nb::cast<const FrozenGraph &>(self).get_csr();
+        if (v >= csr.nvertices) {
+          throw nb::index_error("Vertex out of range.");
+        }
+        return nb::ndarray<nb::numpy, const uint32_t, nb::ndim<1>>(
+            csr.row_begin(v), {(size_t)(csr.row_end(v) - csr.row_begin(v))},
+            self);
+      },
+      "v"_a,
+      "Returns the sorted neighbors of *v* as a read-only "
+      ":class:`numpy.ndarray` viewing the *indices* array.");
+  frozen_graph.def(
+      "is_automorphism",
+      [](const FrozenGraph &self,
+         const nb::ndarray<uint32_t, nb::ndim<1>> &ary) {
+        perform_sanity_checks_on_perm_array(ary, self.get_csr().nvertices);
+        const uint32_t *perm = (const uint32_t *)ary.data();
+        nb::gil_scoped_release release;
+        return self.is_automorphism(perm);
+      },
+      "perm"_a,
+      "Return true only if *perm* is an automorphism of this graph. *perm* "
+      "must contain N elements and be a bijection on {0,1,...,N-1}, "
+      "otherwise the result is undefined.");
+  frozen_graph.def(
+      "to_graph",
+      [](const FrozenGraph &self) {
+        nb::gil_scoped_release release;
+        return graph_from_csr<Graph>(self.get_csr()).release();
+      },
+      "Returns the :class:`Graph` with the same vertices, colors and "
+      "edges.");
+  for (const char *name :
+       {"find_automorphisms", "automorphism_generators", "orbits",
+        "get_permutation_to_canonical_form", "canonical_certificate",
+        "canonical_labeling_by_components", "refinement_invariant"}) {
+    frozen_graph.def(
+        name,
+        [name](const FrozenGraph &self, nb::args args, nb::kwargs kwargs) {
+          return call_on_graph(self, name, args, kwargs);
+        },
+        "Same as the :class:`Graph` method of the same name.");
+  }
+}
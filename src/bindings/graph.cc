@@ -1,12 +1,28 @@
+#include <algorithm>
 #include <bliss/digraph.hh>
 #include <bliss/graph.hh>
+#include <bliss/orbit.hh>
 #include <bliss/stats.hh>
 #include <cstring>
 #include <nanobind/nanobind.h>
 #include <nanobind/stl/function.h>
 #include <nanobind/stl/optional.h>
+#include <nanobind/stl/vector.h>
+#include <memory>
 #include <optional>
+#include <pybliss_certificate.h>
+#include <pybliss_components.h>
+#include <pybliss_csr.h>
 #include <pybliss_ext.h>
+#include <pybliss_graph_access.h>
+#include <pybliss_io.h>
+#include <pybliss_parallel.h>
+#include <pybliss_refinement.h>
+#include <pybliss_parallel_search.h>
+#include <pybliss_search.h>
+#include <pybliss_search_context.h>
+#include <pybliss_serialization.h>
+#include <vector>
 
 #if _MSC_VER
 #define __FORCE_INLINE __forceinline
@@ -17,6 +33,493 @@
 using namespace bliss;
 template <typename T> inline constexpr bool always_false_v = false;
 
+using EdgeArray = nb::ndarray<uint32_t, nb::ndim<2>, nb::c_contig>;
+using ColorArray = nb::ndarray<uint32_t, nb::ndim<1>, nb::c_contig>;
+using PermArray = nb::ndarray<uint32_t, nb::ndim<1>>;
+using PermsArray = nb::ndarray<const uint32_t, nb::ndim<2>, nb::c_contig>;
+using ByteArray = nb::ndarray<const uint8_t, nb::ndim<1>, nb::c_contig>;
+
+/**
+ * Returns the data of \p out, which must be a writable, contiguous uint32
+ * array of \p size elements. Unlike for regular arguments, no conversion is
+ * attempted, as the result would be written into a temporary copy.
+ */
+static uint32_t *get_out_array_data(nb::handle out, size_t size) {
+  nb::ndarray<uint32_t, nb::ndim<1>, nb::c_contig> ary;
+  if (!nb::try_cast(out, ary, false)) {
+    throw std::runtime_error(
+        "'out' must be a writable, contiguous uint32 array.");
+  }
+  if (ary.shape(0) != size) {
+    throw std::runtime_error(
+        "'out' must have an entry for every vertex of the graph.");
+  }
+  return (uint32_t *)ary.data();
+}
+
+#define PARALLEL_SEARCH_DOC                                                    \
+  "The search branches on the vertices of the cell that the splitting "        \
+  "heuristic (see :meth:`set_splitting_heuristic`) picks among the cells of "  \
+  "the partition computed by color refinement (see "                           \
+  ":meth:`refinement_invariant`), skipping those already known to be in the "  \
+  "orbit of an earlier branch, and every branch is a sequential bliss "        \
+  "search. The branches are shared among the threads through work stealing. "  \
+  "If refinement alone distinguishes all the vertices, the search runs "       \
+  "sequentially. The branches are committed in a fixed order, so the "         \
+  "results do not depend on the number of threads. *report* and *terminate* "  \
+  "may then be called from any of the threads, and the statistics in "         \
+  "*stats* combine those of all the branches."
+
+static SearchLimits make_search_limits(std::optional<double> time_limit,
+                                       std::optional<uint64_t> max_nodes,
+                                       std::optional<uint64_t> max_generators,
+                                       const CancellationToken *cancel) {
+  SearchLimits limits;
+  limits.time_limit = time_limit;
+  limits.max_nodes = max_nodes;
+  limits.max_generators = max_generators;
+  limits.cancel = cancel;
+  return limits;
+}
+
+#define SEARCH_LIMITS_DOC                                                      \
+  "The search can be bounded by budgets that are checked natively at every "  \
+  "search tree node, at no noticeable cost:\n\n"                              \
+  ":arg time_limit: Wall-clock time budget in seconds.\n"                     \
+  ":arg max_nodes: Maximum number of search tree nodes to visit.\n"           \
+  ":arg max_generators: Stop once this many generators were found.\n"         \
+  ":arg cancel: A :class:`CancellationToken` that stops the search once "     \
+  "cancelled, e.g. from another thread.\n\n"                                 \
+  "If the search stops early, :attr:`Stats.completed` is *False* and "        \
+  ":attr:`Stats.stop_reason` names the budget that ran out; the results "     \
+  "then only cover the part of the search tree that was explored."
+
+/**
+ * Adds an edge for every row of the (k, 2)-shaped array \p ary to \p g.
+ * The whole array is validated before \p g is modified.
+ */
+template <typename GraphT>
+static void add_edges_from_array(GraphT &g, const EdgeArray &ary) {
+  if (ary.shape(1) != 2) {
+    throw std::runtime_error("Edge array must be of shape (k, 2).");
+  }
+  const size_t nvertices = g.get_nof_vertices();
+  const size_t nedges = ary.shape(0);
+  const uint32_t *edges = (const uint32_t *)ary.data();
+
+  nb::gil_scoped_release release;
+  for (size_t i = 0; i < 2 * nedges; ++i) {
+    if (edges[i] >= nvertices) {
+      throw std::runtime_error(
+          "Edge array must use 0-based labeling of the vertices.");
+    }
+  }
+  GraphAccess<GraphT>::add_edges(g, edges, nedges);
+}
+
+/**
+ * Sets the color of every vertex of \p g from the N-long array \p ary.
+ */
+template <typename GraphT>
+static void set_colors_from_array(GraphT &g, const ColorArray &ary) {
+  if (ary.shape(0) != g.get_nof_vertices()) {
+    throw std::runtime_error(
+        "Color array must have an entry for every vertex of the graph.");
+  }
+  GraphAccess<GraphT>::set_colors(g, (const uint32_t *)ary.data());
+}
+
+/**
+ * Returns a new graph with the vertices, colors and edges of \p parsed.
+ */
+template <typename GraphT>
+static GraphT *graph_from_parsed(const ParsedGraph &parsed) {
+  auto g = std::make_unique<GraphT>(parsed.nvertices);
+  GraphAccess<GraphT>::add_edges(*g, parsed.edges.data(),
+                                 parsed.edges.size() / 2);
+  GraphAccess<GraphT>::set_colors(*g, parsed.colors.data());
+  return g.release();
+}
+
+/**
+ * Decodes the output of serialize_graph held by the bytes-like object
+ * \p data, without holding the GIL.
+ */
+template <typename GraphT>
+static void
+decode_bytes(const ByteArray &data, ParsedGraph &parsed,
+             typename GraphAccess<GraphT>::SearchOptions &options) {
+  nb::gil_scoped_release release;
+  deserialize_graph<GraphT>((const uint8_t *)data.data(), data.shape(0), parsed,
+                            options);
+}
+
+/**
+ * Python iterator over the graphs of an input holding several graphs, such
+ * as a multi-graph DIMACS file or a graph6 file.
+ */
+template <typename GraphT> class GraphIterator {
+public:
+  using ReadGraphFunction = bool (*)(LineReader &, ParsedGraph &);
+
+  GraphIterator(nb::object source, ReadGraphFunction read_graph)
+      : reader(open_byte_source(source)), read_graph(read_graph) {}
+
+  GraphT *next() {
+    nb::gil_scoped_release release;
+    if (!read_graph(reader, parsed)) {
+      throw nb::stop_iteration();
+    }
+    return graph_from_parsed<GraphT>(parsed);
+  }
+
+private:
+  LineReader reader;
+  ReadGraphFunction read_graph;
+  ParsedGraph parsed;
+};
+
+/**
+ * Returns the edges of \p g stored as in ParsedGraph, each undirected edge
+ * listed once. If \p perm is not null, vertex i is relabeled as perm[i].
+ */
+template <typename GraphT>
+static std::vector<uint32_t> collect_edges(GraphT &g, const uint32_t *perm) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const auto &vertices = Access::vertices_of(g);
+  std::vector<uint32_t> edges;
+  for (uint32_t v = 0; v < vertices.size(); ++v) {
+    for (uint32_t w : Access::out_edges(vertices[v])) {
+      if (Access::is_directed || w >= v) {
+        edges.push_back(perm ? perm[v] : v);
+        edges.push_back(perm ? perm[w] : w);
+      }
+    }
+  }
+  return edges;
+}
+
+/**
+ * Returns \p g encoded with \p encode as :class:`bytes`, after relabeling its
+ * vertices with \p perm if given.
+ */
+template <typename GraphT>
+static nb::bytes
+encode_graph(GraphT &g, const std::optional<PermArray> &perm,
+             std::string (*encode)(uint32_t, const std::vector<uint32_t> &)) {
+  const uint32_t *perm_data = nullptr;
+  if (perm) {
+    perform_sanity_checks_on_perm_array(*perm, g.get_nof_vertices());
+    perm_data = (const uint32_t *)perm->data();
+  }
+  std::string encoded;
+  {
+    nb::gil_scoped_release release;
+    encoded = encode(g.get_nof_vertices(), collect_edges(g, perm_data));
+  }
+  return nb::bytes(encoded.data(), encoded.size());
+}
+
+/**
+ * Returns a new graph parsed with \p parse from the :class:`bytes` or
+ * :class:`str` object \p data.
+ */
+template <typename GraphT>
+static GraphT *
+decode_graph(nb::object data,
+             void (*parse)(const char *, const char *, ParsedGraph &)) {
+  if (nb::isinstance<nb::str>(data)) {
+    data = data.attr("encode")("ascii");
+  }
+  if (!nb::isinstance<nb::bytes>(data)) {
+    throw std::runtime_error("Expected a bytes or a str object.");
+  }
+  nb::bytes encoded = nb::borrow<nb::bytes>(data);
+  const char *begin = encoded.c_str();
+  const char *end = begin + encoded.size();
+  while (end != begin && (end[-1] == '\n' || end[-1] == '\r')) {
+    --end;
+  }
+  ParsedGraph parsed;
+  parse(begin, end, parsed);
+  return graph_from_parsed<GraphT>(parsed);
+}
+
+/**
+ * Returns ``(edges, colors)`` for \p g, with every edge of \p g as a row of
+ * the (k, 2)-shaped array *edges*. The edges are listed in the order in which
+ * bliss writes them in the DIMACS format.
+ */
+template <typename GraphT> static nb::tuple to_edge_array(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const auto &vertices = Access::vertices_of(g);
+  const size_t nvertices = vertices.size();
+
+  // Undirected edges are stored at both of their endpoints, keep only the
+  // copy stored at the endpoint with the smaller index.
+  auto is_listed = [](size_t v, unsigned int w) {
+    return Access::is_directed || w >= v;
+  };
+
+  std::unique_ptr<uint32_t[]> colors(new uint32_t[nvertices]);
+  std::unique_ptr<uint32_t[]> edges;
+  size_t nedges = 0;
+  {
+    nb::gil_scoped_release release;
+    for (size_t v = 0; v < nvertices; ++v) {
+      for (unsigned int w : Access::out_edges(vertices[v])) {
+        nedges += is_listed(v, w);
+      }
+    }
+    edges.reset(new uint32_t[2 * nedges]);
+    size_t iedge = 0;
+    for (size_t v = 0; v < nvertices; ++v) {
+      colors[v] = vertices[v].color;
+      for (unsigned int w : Access::out_edges(vertices[v])) {
+        if (is_listed(v, w)) {
+          edges[2 * iedge] = v;
+          edges[2 * iedge + 1] = w;
+          ++iedge;
+        }
+      }
+    }
+  }
+
+  return nb::make_tuple(make_owned_ndarray(edges.release(), {nedges, 2}),
+                        make_owned_ndarray(colors.release(), {nvertices}));
+}
+
+/**
+ * Returns ``(indptr, indices, colors)``, the adjacency of \p g in the
+ * compressed sparse row format, along with the vertex colors.
+ */
+template <typename GraphT> static nb::tuple to_csr(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const auto &vertices = Access::vertices_of(g);
+  const size_t nvertices = vertices.size();
+
+  std::unique_ptr<uint64_t[]> indptr(new uint64_t[nvertices + 1]);
+  std::unique_ptr<uint32_t[]> colors(new uint32_t[nvertices]);
+  std::unique_ptr<uint32_t[]> indices;
+  {
+    nb::gil_scoped_release release;
+    indptr[0] = 0;
+    for (size_t v = 0; v < nvertices; ++v) {
+      indptr[v + 1] = indptr[v] + Access::out_edges(vertices[v]).size();
+      colors[v] = vertices[v].color;
+    }
+    indices.reset(new uint32_t[indptr[nvertices]]);
+    for (size_t v = 0; v < nvertices; ++v) {
+      const auto &nbrs = Access::out_edges(vertices[v]);
+      std::copy(nbrs.begin(), nbrs.end(), &indices[indptr[v]]);
+    }
+  }
+
+  const size_t nnz = indptr[nvertices];
+  return nb::make_tuple(make_owned_ndarray(indptr.release(), {nvertices + 1}),
+                        make_owned_ndarray(indices.release(), {nnz}),
+                        make_owned_ndarray(colors.release(), {nvertices}));
+}
+
+/**
+ * Returns ``(representatives, sizes)`` for the orbits of the automorphism
+ * group of \p g, or of its pointwise stabilizer of the vertices in \p fixed
+ * if given. The stabilizer is obtained as the automorphism group of a copy
+ * of \p g in which every fixed vertex has a color of its own.
+ */
+template <typename GraphT>
+static nb::tuple orbits(GraphT &g, PyStats &stats,
+                        const std::optional<PermArray> &fixed) {
+  const unsigned int nvertices = g.get_nof_vertices();
+  std::unique_ptr<GraphT> individualized;
+  GraphT *searched = &g;
+  if (fixed) {
+    const size_t nfixed = fixed->shape(0);
+    const auto fixed_view = fixed->view();
+    unsigned int max_color = 0;
+    for (unsigned int v = 0; v < nvertices; ++v) {
+      max_color = std::max(max_color, g.get_color(v));
+    }
+    individualized.reset(g.copy());
+    for (size_t i = 0; i < nfixed; ++i) {
+      if (fixed_view(i) >= nvertices) {
+        throw std::runtime_error(
+            "Fixed vertices must be vertices of the graph.");
+      }
+      individualized->change_color(fixed_view(i), max_color + 1 + i);
+    }
+    searched = individualized.get();
+  }
+
+  std::unique_ptr<uint32_t[]> representatives(new uint32_t[nvertices]);
+  std::unique_ptr<uint32_t[]> sizes(new uint32_t[nvertices]);
+  {
+    nb::gil_scoped_release release;
+    Orbit orbit;
+    orbit.init(nvertices);
+    const SearchLimits limits;
+    SearchMonitor monitor(
+        limits, stats,
+        [&orbit](unsigned int n, const unsigned int *aut) {
+          for (unsigned int v = 0; v < n; ++v) {
+            if (aut[v] != v) {
+              orbit.merge_orbits(v, aut[v]);
+            }
+          }
+        },
+        nullptr);
+    searched->find_automorphisms(stats, monitor.report(),
+                                 monitor.terminate());
+    for (unsigned int v = 0; v < nvertices; ++v) {
+      representatives[v] = orbit.get_minimal_representative(v);
+      sizes[v] = orbit.orbit_size(v);
+    }
+  }
+  return nb::make_tuple(
+      make_owned_ndarray(representatives.release(), {(size_t)nvertices}),
+      make_owned_ndarray(sizes.release(), {(size_t)nvertices}));
+}
+
+/**
+ * Returns true if the \p n entries of \p perm are a permutation of [0, n).
+ * \p seen is scratch space.
+ */
+static bool is_permutation(const uint32_t *perm, size_t n,
+                           std::vector<bool> &seen) {
+  seen.assign(n, false);
+  for (size_t i = 0; i < n; ++i) {
+    if (perm[i] >= n || seen[perm[i]]) {
+      return false;
+    }
+    seen[perm[i]] = true;
+  }
+  return true;
+}
+
+static void check_perms_shape(const PermsArray &perms, size_t nvertices) {
+  if (perms.shape(1) != nvertices) {
+    throw std::runtime_error(
+        "Permutation arrays must be of shape (k, N), N being the number of "
+        "vertices in the graph.");
+  }
+}
+
+/**
+ * Returns a boolean array telling for every row of \p perms whether it is an
+ * automorphism of \p g, as bliss's is_automorphism does. Rows that are not
+ * permutations are reported as not being automorphisms.
+ */
+template <typename GraphT>
+static nb::ndarray<nb::numpy, bool>
+is_automorphism_many(GraphT &g, const PermsArray &perms,
+                     unsigned int n_threads) {
+  const size_t nvertices = g.get_nof_vertices();
+  check_perms_shape(perms, nvertices);
+  const size_t nperms = perms.shape(0);
+  const uint32_t *data = (const uint32_t *)perms.data();
+  std::unique_ptr<bool[]> result(new bool[nperms]);
+  {
+    nb::gil_scoped_release release;
+    std::vector<std::vector<bool>> seen(resolve_n_threads(n_threads));
+    parallel_for(nperms, n_threads, [&](size_t i, unsigned int worker) {
+      unsigned int *perm = (unsigned int *)data + i * nvertices;
+      result[i] = is_permutation(perm, nvertices, seen[worker]) &&
+                  g.is_automorphism(perm);
+    });
+  }
+  return make_owned_ndarray(result.release(), {nperms});
+}
+
+/**
+ * Checks that every row of \p perms is a permutation of the vertices of a
+ * graph with \p nvertices vertices, on \p n_threads threads.
+ */
+static void check_permutations(const uint32_t *perms, size_t nperms,
+                               size_t nvertices, unsigned int n_threads) {
+  std::vector<std::vector<bool>> seen(resolve_n_threads(n_threads));
+  parallel_for(nperms, n_threads, [&](size_t i, unsigned int worker) {
+    if (!is_permutation(perms + i * nvertices, nvertices, seen[worker])) {
+      throw std::runtime_error("Row " + std::to_string(i) +
+                               " of 'perms' is not a permutation.");
+    }
+  });
+}
+
+/**
+ * Returns, for every row ``perm`` of \p perms, the graph that
+ * ``g.permute(perm)`` would return, either as its certificate (see
+ * make_certificate) in a list of :class:`bytes`, or as the rows of the arrays
+ * ``(edges, colors)`` of shapes (k, m, 2) and (k, N), edge j of every graph
+ * being the image of edge j of ``g.to_edge_array()``.
+ */
+template <typename GraphT>
+static nb::object permute_many(GraphT &g, const PermsArray &perms,
+                               const std::string &output,
+                               unsigned int n_threads) {
+  using Access = GraphAccess<GraphT>;
+  const size_t nvertices = g.get_nof_vertices();
+  check_perms_shape(perms, nvertices);
+  if (output != "edge_array" && output != "certificate") {
+    throw std::runtime_error(
+        "'output' must be either 'edge_array' or 'certificate'.");
+  }
+  const size_t nperms = perms.shape(0);
+  const uint32_t *data = (const uint32_t *)perms.data();
+
+  if (output == "certificate") {
+    std::vector<std::string> certificates(nperms);
+    {
+      nb::gil_scoped_release release;
+      check_permutations(data, nperms, nvertices, n_threads);
+      Access::normalize(g);
+      std::vector<CertificateScratch> scratch(resolve_n_threads(n_threads));
+      parallel_for(nperms, n_threads, [&](size_t i, unsigned int worker) {
+        make_certificate(g, data + i * nvertices, scratch[worker],
+                         certificates[i]);
+      });
+    }
+    nb::list result;
+    for (const std::string &certificate : certificates) {
+      result.append(nb::bytes(certificate.data(), certificate.size()));
+    }
+    return result;
+  }
+
+  std::vector<uint32_t> base_edges;
+  std::unique_ptr<uint32_t[]> edges, colors(new uint32_t[nperms * nvertices]);
+  size_t nedges = 0;
+  {
+    nb::gil_scoped_release release;
+    check_permutations(data, nperms, nvertices, n_threads);
+    base_edges = collect_edges(g, nullptr);
+    nedges = base_edges.size() / 2;
+    edges.reset(new uint32_t[nperms * 2 * nedges]);
+    const auto &vertices = Access::vertices_of(g);
+    parallel_for(nperms, n_threads, [&](size_t i, unsigned int) {
+      const uint32_t *perm = data + i * nvertices;
+      uint32_t *out = &edges[i * 2 * nedges];
+      for (size_t j = 0; j < nedges; ++j) {
+        uint32_t src = perm[base_edges[2 * j]];
+        uint32_t dst = perm[base_edges[2 * j + 1]];
+        if (!Access::is_directed && src > dst) {
+          std::swap(src, dst);
+        }
+        out[2 * j] = src;
+        out[2 * j + 1] = dst;
+      }
+      for (size_t v = 0; v < nvertices; ++v) {
+        colors[i * nvertices + perm[v]] = vertices[v].color;
+      }
+    });
+  }
+  return nb::make_tuple(
+      make_owned_ndarray(edges.release(), {nperms, nedges, 2}),
+      make_owned_ndarray(colors.release(), {nperms, nvertices}));
+}
+
 template <typename GraphT>
 static inline __FORCE_INLINE void
 bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
@@ -31,6 +534,12 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
                           .. automethod:: set_verbose_file
                           .. automethod:: add_vertex
                           .. automethod:: add_edge
+                          .. automethod:: add_edges
+                          .. automethod:: set_colors
+                          .. automethod:: from_edge_array
+                          .. automethod:: to_edge_array
+                          .. automethod:: from_csr
+                          .. automethod:: to_csr
                           .. automethod:: get_color
                           .. automethod:: change_color
                           .. automethod:: set_failure_recording
@@ -38,15 +547,26 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
                           .. autoattribute:: nvertices
                           .. automethod:: permute
                           .. automethod:: is_automorphism
+                          .. automethod:: is_automorphism_many
+                          .. automethod:: permute_many
                           .. automethod:: find_automorphisms
+                          .. automethod:: automorphism_generators
+                          .. automethod:: orbits
                           .. automethod:: get_permutation_to_canonical_form
+                          .. automethod:: parallel_canonical_labeling
+                          .. automethod:: canonical_certificate
+                          .. automethod:: canonical_labeling_by_components
+                          .. automethod:: refinement_invariant
                           .. automethod:: write_dimacs
                           .. automethod:: to_dimacs
                           .. automethod:: write_dot
                           .. automethod:: to_dot
                           .. automethod:: show_dot
                           .. automethod:: from_dimacs
+                          .. automethod:: iter_dimacs
                           .. automethod:: copy
+                          .. automethod:: to_bytes
+                          .. automethod:: from_bytes
                           .. automethod:: cmp
                           .. automethod:: __eq__
                           .. automethod:: set_long_prune_activity
@@ -55,7 +575,16 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
                         .. note::
 
                           - :class:`Graph` represents an undirected graph, while,
-                          - :class:`Digraph` represents a directed graph.)");
+                          - :class:`Digraph` represents a directed graph.
+
+                        .. note::
+
+                          The automorphism and canonical labeling searches
+                          release the GIL. Distinct graph objects may thus be
+                          searched concurrently from different Python threads.
+                          A single graph object (and a single :class:`Stats`)
+                          must not be used by more than one thread at a
+                          time.)");
   graph.def(nb::init<>());
   graph.def(nb::init<unsigned int>());
   graph.def(
@@ -89,6 +618,69 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
     // See: https://devblogs.microsoft.com/oldnewthing/20200311-00/?p=103553
     static_assert(always_false_v<GraphT>,
                   "GraphT can be either Graph or Digraph");
+  graph.def("add_edges", &add_edges_from_array<GraphT>, "edges"_a,
+            "Add an edge for every row ``[i, j]`` of the "
+            ":math:`(k, 2)`-shaped ``uint32`` array *edges*, as "
+            ":meth:`add_edge` would with ``(i, j)``. All the entries of "
+            "*edges* are checked to be valid vertices before the graph is "
+            "modified.");
+  graph.def("set_colors", &set_colors_from_array<GraphT>, "colors"_a,
+            "Set the color of vertex ``i`` to ``colors[i]`` for every vertex "
+            "in the graph. *colors* must be an N-long ``uint32`` array.");
+  graph.def_static(
+      "from_edge_array",
+      [](unsigned int nvertices, const EdgeArray &edges,
+         std::optional<ColorArray> &colors) {
+        auto g = std::make_unique<GraphT>(nvertices);
+        add_edges_from_array(*g, edges);
+        if (colors) {
+          set_colors_from_array(*g, *colors);
+        }
+        return g.release();
+      },
+      "nvertices"_a, "edges"_a, "colors"_a = nb::none(),
+      "Return a graph with *nvertices* vertices whose edges are the rows of "
+      "*edges* and whose vertex colors are *colors* (all 0 if not given). See "
+      ":meth:`add_edges` and :meth:`set_colors` for the expected arrays.");
+  graph.def_static(
+      "from_csr",
+      [](const IndexArray &indptr, const IndexArray &indices,
+         const std::optional<CsrColorArray> &colors) {
+        const CsrGraph csr = csr_from_arrays(indptr, indices, colors);
+        nb::gil_scoped_release release;
+        validate_csr(csr, false);
+        return graph_from_csr<GraphT>(csr).release();
+      },
+      "indptr"_a, "indices"_a, "colors"_a = nb::none(),
+      "Return a graph whose adjacency is given in the compressed sparse row "
+      "format, as returned by :meth:`to_csr` or stored by "
+      ":class:`scipy.sparse.csr_array`: the neighbors of vertex ``i`` are "
+      "``indices[indptr[i]:indptr[i+1]]``, and the vertex colors are "
+      "*colors* (all 0 if not given). For :class:`Digraph` these are the "
+      "targets of the edges leaving ``i``. For :class:`Graph` the adjacency "
+      "must be symmetric, an edge ``{i, j}`` being listed in the rows of both"
+      " ``i`` and ``j`` (and a self-loop once).\n\n"
+      "*indptr* may be an array of any 32- or 64-bit integer type and "
+      "*indices* an ``int32`` or ``uint32`` array, so the arrays of a "
+      "SciPy sparse matrix are read without conversion. Every adjacency list "
+      "is allocated once, at its final size, and the GIL is released while "
+      "the graph is built.");
+  graph.def("to_edge_array", &to_edge_array<GraphT>,
+            "Returns ``(edges, colors)``, where *edges* is a "
+            ":math:`(k, 2)`-shaped ``uint32`` :class:`numpy.ndarray` with a "
+            "row ``[i, j]`` for every edge of the graph and *colors* is an "
+            "N-long ``uint32`` :class:`numpy.ndarray` of the vertex colors. "
+            "For :class:`Graph`, every undirected edge is listed once with "
+            "``i <= j``. Duplicate edges are removed from the graph as a side "
+            "effect.");
+  graph.def("to_csr", &to_csr<GraphT>,
+            "Returns ``(indptr, indices, colors)``, the adjacency of the graph "
+            "in the compressed sparse row format: the (sorted) neighbors of "
+            "vertex ``i`` are ``indices[indptr[i]:indptr[i+1]]``. For "
+            ":class:`Digraph` these are the targets of the edges leaving "
+            "``i``. *indptr* is a ``uint64`` array, *indices* and *colors* "
+            "are ``uint32`` arrays. Duplicate edges are removed from the graph "
+            "as a side effect.");
   graph.def("get_color", &GraphT::get_color, "v"_a,
             "Returns the color of the vertex *v*");
   graph.def("change_color", &GraphT::change_color, "v"_a, "c"_a,
@@ -131,33 +723,75 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       " Return true only if *perm* is an automorphism of this graph."
       " *perm* must contain N=this.get_nof_vertices() elements and be a"
       " bijection on {0,1,...,N-1}, otherwise the result is undefined.");
+  graph.def("is_automorphism_many", &is_automorphism_many<GraphT>,
+            "perms"_a, "n_threads"_a = 0,
+            "Returns a boolean :class:`numpy.ndarray` whose entry ``i`` tells "
+            "whether ``perms[i]`` is an automorphism of this graph, as "
+            ":meth:`is_automorphism` would. *perms* is a C-contiguous "
+            "``uint32`` array of shape :math:`(k, N)`, and its rows are "
+            "checked on *n_threads* native threads (one per hardware thread "
+            "if 0) without the GIL. Rows that are not permutations of the "
+            "vertices are reported as *False*. The graph must not be "
+            "modified by other threads meanwhile.");
+  graph.def("permute_many", &permute_many<GraphT>, "perms"_a,
+            "output"_a = "edge_array", "n_threads"_a = 0,
+            "Applies every row of *perms*, a C-contiguous ``uint32`` array "
+            "of shape :math:`(k, N)`, to this graph as :meth:`permute` "
+            "would, without building the :math:`k` graphs. The rows are "
+            "processed on *n_threads* native threads (one per hardware thread"
+            " if 0) without the GIL, and must all be permutations of the "
+            "vertices. Depending on *output*, returns:\n\n"
+            "- ``\"edge_array\"``: ``(edges, colors)``, the arrays "
+            ":meth:`to_edge_array` would return for every permuted graph, "
+            "stacked into ``uint32`` arrays of shapes :math:`(k, m, 2)` and "
+            ":math:`(k, N)`. ``edges[i, j]`` is the image under ``perms[i]`` "
+            "of the edge ``j`` of :meth:`to_edge_array`, for "
+            ":class:`Graph` with its smaller endpoint first.\n"
+            "- ``\"certificate\"``: a list of the :class:`bytes` encodings "
+            "of the permuted graphs in the format of the certificates of "
+            ":meth:`canonical_certificate`. Two rows give equal certificates "
+            "if and only if they give equal graphs, e.g. ``perms[i]`` and "
+            "``perms[j]`` differ by an automorphism.\n\n"
+            "Duplicate edges are removed from the graph as a side effect.");
   graph.def(
       "find_automorphisms",
-      [](GraphT &self, Stats &stats,
-         std::optional<const std::function<void(
-             int, nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy,
-                              nb::c_contig>)>> &py_report,
-         std::optional<const std::function<bool()>> &py_terminate) {
-        std::function<void(unsigned int, const unsigned int *)> cpp_report =
-            nullptr;
-        std::function<bool()> cpp_terminate = nullptr;
-
-        if (py_report) {
-          cpp_report = [&](unsigned int n, const unsigned int *aut) {
-            auto np_aut =
-                nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy,
-                            nb::c_contig>(aut, {self.get_nof_vertices()});
-            (*py_report)(n, np_aut);
-          };
+      [](GraphT &self, PyStats &stats,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate,
+         std::optional<double> time_limit, std::optional<uint64_t> max_nodes,
+         std::optional<uint64_t> max_generators,
+         const CancellationToken *cancel,
+         std::optional<unsigned int> n_threads,
+         const std::optional<std::vector<typename GraphT::SplittingHeuristic>>
+             &portfolio) {
+        if (portfolio && portfolio->empty()) {
+          throw std::runtime_error("'portfolio' cannot be empty.");
         }
-
-        if (py_terminate) {
-          cpp_terminate = *py_terminate;
+        if (portfolio && n_threads) {
+          throw std::runtime_error(
+              "'portfolio' and 'n_threads' cannot be combined.");
         }
+        const SearchLimits limits = make_search_limits(
+            time_limit, max_nodes, max_generators, cancel);
+        SearchMonitor monitor(
+            limits, stats, wrap_py_report(py_report, self.get_nof_vertices()),
+            wrap_py_terminate(py_terminate));
 
-        self.find_automorphisms(stats, cpp_report, cpp_terminate);
+        nb::gil_scoped_release release;
+        if (portfolio) {
+          portfolio_search(self, *portfolio, monitor, stats);
+        } else if (n_threads) {
+          SearchContext context;
+          parallel_search(self, false, *n_threads, monitor, stats, context);
+        } else {
+          self.find_automorphisms(stats, monitor.report(),
+                                  monitor.terminate());
+        }
       },
       "stats"_a, "report"_a = nb::none(), "terminate"_a = nb::none(),
+      "time_limit"_a = nb::none(), "max_nodes"_a = nb::none(),
+      "max_generators"_a = nb::none(), "cancel"_a = nb::none(),
+      "n_threads"_a = nb::none(), "portfolio"_a = nb::none(),
       "Find a set of generators for the automorphism group of the graph. "
       "The function *report* (if not None) is called each time a new "
       "generator for the automorphism group is found. The first argument "
@@ -177,40 +811,108 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       "generated. The *terminate* function may be used to limit the time "
       "spent in bliss in case the graph is too difficult under the "
       "available time constraints. If used, keep the function simple to "
-      "evaluate so that it does not consume too much time. ");
+      "evaluate so that it does not consume too much time.\n\n"
+
+      "The GIL is released for the duration of the search and re-acquired "
+      "only while *report* or *terminate* run.\n\n" SEARCH_LIMITS_DOC
+      "\n\n:arg n_threads: If not *None*, the first level of the search tree "
+      "is explored on *n_threads* native threads (one per hardware thread "
+      "if 0). " PARALLEL_SEARCH_DOC
+      "\n:arg portfolio: If not *None*, a list of :class:`SplittingHeuristic`"
+      " s to race: the automorphism group is searched once per heuristic, "
+      "each on a copy of the graph and on a native thread of its own, and "
+      "the searches still running are stopped as soon as one completes. "
+      "The heuristic set by :meth:`set_splitting_heuristic` is then ignored. "
+      "*stats* describes the winning search, and "
+      ":attr:`Stats.portfolio_winner` is the index of its heuristic in "
+      "*portfolio*. *report* is called with the generators of the winning "
+      "search only, after the race is over. The budgets apply to all the "
+      "searches together, except for *max_generators*, which each search "
+      "checks on its own, and *terminate* may be called from any of the "
+      "threads. Cannot be combined with *n_threads*.");
   graph.def(
-      "get_permutation_to_canonical_form",
-      [](GraphT &self, Stats &stats,
-         std::optional<const std::function<void(
-             int, nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy,
-                              nb::c_contig>)>> &py_report,
-         std::optional<const std::function<bool()>> &py_terminate) {
-        std::function<void(unsigned int, const unsigned int *)> cpp_report =
-            nullptr;
-        std::function<bool()> cpp_terminate = nullptr;
-
-        if (py_report) {
-          cpp_report = [&](unsigned int n, const unsigned int *aut) {
-            auto np_aut =
-                nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy,
-                            nb::c_contig>(aut, {self.get_nof_vertices()});
-            (*py_report)(n, np_aut);
-          };
+      "automorphism_generators",
+      [](GraphT &self, PyStats &stats, std::optional<double> time_limit,
+         std::optional<uint64_t> max_nodes,
+         std::optional<uint64_t> max_generators,
+         const CancellationToken *cancel) {
+        const size_t nvertices = self.get_nof_vertices();
+        std::vector<uint32_t> generators;
+        const SearchLimits limits = make_search_limits(
+            time_limit, max_nodes, max_generators, cancel);
+        SearchMonitor monitor(
+            limits, stats,
+            [&generators](unsigned int n, const unsigned int *aut) {
+              generators.insert(generators.end(), aut, aut + n);
+            },
+            nullptr);
+        {
+          nb::gil_scoped_release release;
+          self.find_automorphisms(stats, monitor.report(),
+                                  monitor.terminate());
         }
+        const size_t ngenerators =
+            nvertices ? generators.size() / nvertices : 0;
+        return make_owned_ndarray(std::move(generators),
+                                  {ngenerators, nvertices});
+      },
+      "stats"_a, "time_limit"_a = nb::none(), "max_nodes"_a = nb::none(),
+      "max_generators"_a = nb::none(), "cancel"_a = nb::none(),
+      "Returns a set of generators for the automorphism group of the graph "
+      "as a C-contiguous :class:`numpy.ndarray` of dtype ``uint32`` and "
+      "shape :math:`(k, N)`, whose rows are the generators that "
+      ":meth:`find_automorphisms` would report, in the same order. The "
+      "generators are collected natively during the search, which runs "
+      "with the GIL released and without calling back into Python.\n\n"
+      "The search statistics are copied in *stats*.\n\n" SEARCH_LIMITS_DOC);
+  graph.def("orbits", &orbits<GraphT>, "stats"_a, "fixed"_a = nb::none(),
+            "Returns ``(representatives, sizes)``, two :class:`numpy.ndarray` "
+            "s of dtype ``uint32`` and length :math:`N` describing the "
+            "orbits of the automorphism group on the vertices: "
+            "``representatives[v]`` is the smallest vertex in the orbit of "
+            "*v* and ``sizes[v]`` is the number of vertices in that orbit. "
+            "The orbits are computed natively from the generators found by "
+            "the search, which runs with the GIL released.\n\n"
+            "The search statistics are copied in *stats*.\n\n"
+            ":arg fixed: If not *None*, a 1D ``uint32`` array of vertices. The "
+            "orbits are then those of the pointwise stabilizer of *fixed*, "
+            "i.e. of the subgroup of automorphisms mapping every vertex of "
+            "*fixed* to itself, and *stats* describes the search for that "
+            "subgroup.");
+  graph.def(
+      "get_permutation_to_canonical_form",
+      [](GraphT &self, PyStats &stats,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate,
+         std::optional<double> time_limit, std::optional<uint64_t> max_nodes,
+         std::optional<uint64_t> max_generators,
+         const CancellationToken *cancel, nb::object out) {
+        const unsigned int nvertices = self.get_nof_vertices();
+        uint32_t *out_data =
+            out.is_none() ? nullptr : get_out_array_data(out, nvertices);
+        const SearchLimits limits = make_search_limits(
+            time_limit, max_nodes, max_generators, cancel);
+        SearchMonitor monitor(limits, stats,
+                              wrap_py_report(py_report, nvertices),
+                              wrap_py_terminate(py_terminate));
 
-        if (py_terminate) {
-          cpp_terminate = *py_terminate;
+        const unsigned int *perm = nullptr;
+        {
+          nb::gil_scoped_release release;
+          perm = self.canonical_form(stats, monitor.report(),
+                                     monitor.terminate());
         }
-
-        auto perm = self.canonical_form(stats, cpp_report, cpp_terminate);
-        nb::module_ np = nb::module_::import_("numpy");
-        auto np_perm =
-            np.attr("empty")(self.get_nof_vertices(), np.attr("uint32"));
-        std::memcpy(nb::cast<nb::ndarray<>>(np_perm).data(), perm,
-                    sizeof(uint32_t) * self.get_nof_vertices());
-        return np_perm;
+        if (out_data) {
+          std::memcpy(out_data, perm, sizeof(uint32_t) * nvertices);
+          return out;
+        }
+        std::vector<unsigned int> labeling(perm, perm + nvertices);
+        return nb::cast(make_owned_ndarray(std::move(labeling), {nvertices}));
       },
       "stats"_a, "report"_a = nb::none(), "terminate"_a = nb::none(),
+      "time_limit"_a = nb::none(), "max_nodes"_a = nb::none(),
+      "max_generators"_a = nb::none(), "cancel"_a = nb::none(),
+      "out"_a = nb::none(),
       "Returns `P`, a :class:`numpy.ndarray` on {0, ..., nvertices-1}. "
       "Applying the 'permutation `P` to this graph results in this graph's "
       "canonical graph. The function *report* (if not None) is called each "
@@ -233,20 +935,197 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       "available time constraints. If used, keep the function simple to "
       "evaluate so that it does not consume too much time.\n\n"
 
+      "The GIL is released for the duration of the search and re-acquired "
+      "only while *report* or *terminate* run.\n\n" SEARCH_LIMITS_DOC
+      " In particular, `P` is then not guaranteed to lead to the canonical "
+      "form.\n\n"
+
+      ":arg out: If not *None*, a writable, contiguous ``uint32`` "
+      ":class:`numpy.ndarray` of length N into which `P` is written, and "
+      "which is returned. Together with a reused *stats*, this makes "
+      "repeated calls allocation-free on the Python side.\n\n"
+
       "This wraps the method canonical_form from the C++-API.");
+  graph.def(
+      "parallel_canonical_labeling",
+      [](GraphT &self, PyStats &stats, unsigned int n_threads,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate,
+         std::optional<double> time_limit, std::optional<uint64_t> max_nodes,
+         std::optional<uint64_t> max_generators,
+         const CancellationToken *cancel, nb::object out,
+         SearchContext *context) {
+        const unsigned int nvertices = self.get_nof_vertices();
+        uint32_t *out_data =
+            out.is_none() ? nullptr : get_out_array_data(out, nvertices);
+        const SearchLimits limits = make_search_limits(
+            time_limit, max_nodes, max_generators, cancel);
+        SearchMonitor monitor(limits, stats,
+                              wrap_py_report(py_report, nvertices),
+                              wrap_py_terminate(py_terminate));
+
+        SearchContext local_context;
+        SearchContext &ctx = context ? *context : local_context;
+        SearchContext::Lease lease(ctx);
+        {
+          nb::gil_scoped_release release;
+          parallel_search(self, true, n_threads, monitor, stats, ctx);
+          if (ctx.labeling.empty()) {
+            // Stopped before any branch completed.
+            ctx.labeling.resize(nvertices);
+            for (unsigned int v = 0; v < nvertices; ++v) {
+              ctx.labeling[v] = v;
+            }
+          }
+        }
+        if (out_data) {
+          std::memcpy(out_data, ctx.labeling.data(),
+                      sizeof(uint32_t) * nvertices);
+          return out;
+        }
+        std::vector<unsigned int> labeling(ctx.labeling);
+        return nb::cast(make_owned_ndarray(std::move(labeling), {nvertices}));
+      },
+      "stats"_a, "n_threads"_a = 0, "report"_a = nb::none(),
+      "terminate"_a = nb::none(), "time_limit"_a = nb::none(),
+      "max_nodes"_a = nb::none(), "max_generators"_a = nb::none(),
+      "cancel"_a = nb::none(), "out"_a = nb::none(), "context"_a = nb::none(),
+      "Returns `P`, a :class:`numpy.ndarray` on {0, ..., nvertices-1} "
+      "mapping this graph to its *parallel* canonical form, which is "
+      "computed on several native threads. The parallel canonical form "
+      "``self.permute(P)`` is a canonical form of its own: it is equal for "
+      "isomorphic graphs with the same search options and the same for any "
+      "number of threads, but it is in general not the one that "
+      ":meth:`get_permutation_to_canonical_form` gives, as bliss "
+      "chooses its labeling among the leaves of a single search tree, which "
+      "cannot be split between threads. Only compare parallel canonical "
+      "forms with each other, and do not mix them with "
+      ":meth:`canonical_certificate`, :class:`CanonicalIndex` or "
+      ":func:`canonicalize_many` results.\n\n"
+      "The parallel search keeps the labeling of the branch with the "
+      "smallest canonical certificate. *stats*, *report*, *terminate*, "
+      "*time_limit*, *max_nodes*, *max_generators*, *cancel* and *out* have "
+      "the same meaning as for :meth:`get_permutation_to_canonical_form`. "
+      "The GIL is released for the duration of the search.\n\n"
+      ":arg n_threads: The number of native threads exploring the first "
+      "level of the search tree, one per hardware thread if 0. "
+      PARALLEL_SEARCH_DOC "\n\n"
+      ":arg context: If not *None*, a :class:`SearchContext` holding the "
+      "labeling and the per-thread certificate scratch memory of the "
+      "search, instead of allocating them for this call only.");
+  graph.def(
+      "canonical_certificate",
+      [](GraphT &self, PyStats &stats,
+         std::optional<const PyReportFunction> &py_report,
+         std::optional<const std::function<bool()>> &py_terminate,
+         SearchContext *context) {
+        const SearchLimits limits;
+        SearchMonitor monitor(
+            limits, stats, wrap_py_report(py_report, self.get_nof_vertices()),
+            wrap_py_terminate(py_terminate));
+
+        SearchContext local_context;
+        SearchContext &ctx = context ? *context : local_context;
+        SearchContext::Lease lease(ctx);
+        Hash128 hash;
+        {
+          nb::gil_scoped_release release;
+          const unsigned int *perm = self.canonical_form(
+              stats, monitor.report(), monitor.terminate());
+          make_certificate(self, perm, ctx.certificate_scratch,
+                           ctx.certificate);
+          hash = murmur3_128(ctx.certificate.data(), ctx.certificate.size());
+        }
+        return nb::make_tuple(
+            nb::bytes(ctx.certificate.data(), ctx.certificate.size()),
+            uint128_to_int(hash.lo, hash.hi));
+      },
+      "stats"_a, "report"_a = nb::none(), "terminate"_a = nb::none(),
+      "context"_a = nb::none(),
+      "Returns ``(certificate, hash)`` identifying this graph up to "
+      "isomorphism, where *certificate* is a compact :class:`bytes` "
+      "encoding of the canonical graph (its vertex colors and sorted "
+      "adjacency lists) and *hash* is a 128-bit :class:`int` hash of "
+      "*certificate*. Two graphs of the same type are isomorphic if and only "
+      "if their certificates are equal, provided both were computed with "
+      "the same options affecting the canonical labeling: the splitting "
+      "heuristic (see :meth:`set_splitting_heuristic`), component recursion "
+      "(see :meth:`set_component_recursion`) and long prune (see "
+      ":meth:`set_long_prune_activity`).\n\n"
+      "This is equivalent to encoding "
+      "``self.permute(self.get_permutation_to_canonical_form(stats))`` but "
+      "the certificate is computed in place right after the search, without "
+      "building the canonical graph. The arguments have the same meaning as "
+      "for :meth:`get_permutation_to_canonical_form`.\n\n"
+      ":arg context: If not *None*, a :class:`SearchContext` whose scratch "
+      "memory is used to build the certificate, instead of allocating it "
+      "for this call only.");
+  graph.def(
+      "canonical_labeling_by_components",
+      [](GraphT &self, ComponentCache *cache) {
+        std::vector<uint32_t> labeling;
+        {
+          nb::gil_scoped_release release;
+          labeling = canonical_labeling_by_components(self, cache);
+        }
+        const size_t nvertices = labeling.size();
+        return make_owned_ndarray(std::move(labeling), {nvertices});
+      },
+      "cache"_a = nb::none(),
+      "Returns a canonical labeling of the graph, as a :class:`numpy.ndarray`"
+      " of dtype ``uint32``, computed component by component: the connected "
+      "components (weakly connected for a :class:`Digraph`) are "
+      "canonicalized separately and then laid out one after the other, "
+      "ordered by their canonical forms. ``self.permute(labeling)`` is thus "
+      "the same graph for all isomorphic graphs, though in general not the "
+      "one that :meth:`get_permutation_to_canonical_form` gives.\n\n"
+      "The components are searched with the options of this graph (e.g. "
+      "its splitting heuristic). If *cache*, a :class:`ComponentCache`, is "
+      "given, the canonical labelings of the components are looked up in and"
+      " added to it, so that a component that recurs within the graph or "
+      "across calls is searched once. The GIL is released throughout.");
+  graph.def(
+      "refinement_invariant",
+      [](GraphT &self) {
+        std::vector<uint32_t> colors;
+        Hash128 hash;
+        {
+          nb::gil_scoped_release release;
+          hash = refine_colors(self, colors);
+        }
+        return nb::make_tuple(uint128_to_int(hash.lo, hash.hi),
+                              make_owned_ndarray(std::move(colors),
+                                                 {self.get_nof_vertices()}));
+      },
+      "Returns ``(hash, colors)`` computed by color refinement (the "
+      "1-dimensional Weisfeiler-Leman algorithm) alone, without any "
+      "search: starting from the vertex colors, the vertices are "
+      "repeatedly split by the colors of their neighbors until the "
+      "coloring is stable.\n\n"
+      "- *colors* is a :class:`numpy.ndarray` of dtype ``uint32`` holding "
+      "the stable color of every vertex, the colors being numbered "
+      "canonically from 0. Every isomorphism between two graphs maps the "
+      "vertices of a color to the vertices of the same color.\n"
+      "- *hash* is a 128-bit :class:`int` hash of the initial cells and of "
+      "every split performed by the refinement.\n\n"
+      "Graphs of the same type with different hashes are not isomorphic, "
+      "so that comparing hashes is a cheap pre-filter before computing "
+      "canonical forms. Equal hashes do not imply isomorphism: e.g. all "
+      "regular graphs with the same number of vertices and degree get the "
+      "same hash. See :func:`refinement_invariants` for many graphs.");
   graph.def_static(
       "from_dimacs",
-      [](nb::object file_obj) {
-        FILE *fp = get_fp_from_readable_pyobj(file_obj);
-        GraphT *ptr = nullptr;
-        auto err_str = capture_string_written_to_file([&](FILE *err_stream) {
-          ptr = GraphT::read_dimacs(fp, err_stream);
-        });
-        if (!ptr) {
-          throw std::runtime_error(
-              "Error during reading GraphT from DIMACS.\n" + err_str);
+      [](nb::object source) {
+        LineReader reader(open_byte_source(source));
+        ParsedGraph parsed;
+        {
+          nb::gil_scoped_release release;
+          if (!read_dimacs_graph(reader, parsed)) {
+            throw std::runtime_error(
+                "Error while reading DIMACS: no graph found in the input.");
+          }
         }
-        return ptr;
+        return graph_from_parsed<GraphT>(parsed);
       },
       "fp"_a,
       "Return a graph corresponding to DIMACS-formatted graph present in *fp*. "
@@ -255,7 +1134,104 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       "vertices are numbered from 1 to N while in this API they are from 0 to "
       "N-1. Thus the vertex n in the file corresponds to the vertex n-1 in the "
       "API.\n\n"
-      ":arg fp: The file stream from where the graph is to be read.");
+      ":arg fp: The source from where the graph is to be read. Either a "
+      "file object, any object with a ``read`` method (e.g. "
+      ":class:`io.BytesIO`, :class:`gzip.GzipFile`), a :class:`bytes`-like "
+      "object holding the DIMACS text, or a path to a file. Regular files "
+      "given as paths or as binary file objects are memory-mapped, a file "
+      "object from its current position. If the source holds several "
+      "graphs, the first one is returned, see :meth:`iter_dimacs`.");
+  graph.def_static(
+      "iter_dimacs",
+      [](nb::object source) {
+        return std::make_unique<GraphIterator<GraphT>>(source,
+                                                       read_dimacs_graph)
+            .release();
+      },
+      "fp"_a,
+      "Return an iterator over the graphs in *fp*, a concatenation of "
+      "DIMACS-formatted graphs, each starting with its problem line. The "
+      "graphs are parsed lazily, one per iteration. *fp* accepts the same "
+      "sources as :meth:`from_dimacs`.");
+  if constexpr (std::is_same<GraphT, Graph>::value) {
+    graph.def_static(
+        "from_graph6",
+        [](nb::object data) {
+          return decode_graph<GraphT>(data, parse_graph6);
+        },
+        "data"_a,
+        "Return the graph encoded in the graph6 or sparse6 format in *data*, "
+        "a :class:`bytes` or :class:`str` object holding a single line. See "
+        "`formats.txt <https://users.cecs.anu.edu.au/~bdm/data/formats.txt>`_"
+        " for the definition of the formats. All vertices have color 0.");
+    graph.def_static(
+        "iter_graph6",
+        [](nb::object source) {
+          return std::make_unique<GraphIterator<GraphT>>(source,
+                                                         read_graph6_graph)
+              .release();
+        },
+        "fp"_a,
+        "Return an iterator over the graphs in *fp*, which holds one graph "
+        "per line in the graph6 or sparse6 format. The lines are parsed "
+        "lazily, one per iteration. *fp* accepts the same sources as "
+        ":meth:`~pybliss.Graph.from_dimacs`.");
+    graph.def(
+        "to_graph6",
+        [](GraphT &self, const std::optional<PermArray> &perm) {
+          return encode_graph(self, perm, encode_graph6);
+        },
+        "perm"_a = nb::none(),
+        "Returns the graph6 encoding of the graph as :class:`bytes`, without "
+        "a trailing newline. Vertex colors are not encoded, and self-loops "
+        "cannot be encoded (see :meth:`~pybliss.Graph.to_sparse6`). If "
+        "*perm* is given, the graph is encoded as if "
+        ":meth:`~pybliss.Graph.permute` was applied to it first, e.g. "
+        "``g.to_graph6(g.get_permutation_to_canonical_form(stats))`` "
+        "encodes the canonical form of *g*.");
+    graph.def(
+        "to_sparse6",
+        [](GraphT &self, const std::optional<PermArray> &perm) {
+          return encode_graph(self, perm, encode_sparse6);
+        },
+        "perm"_a = nb::none(),
+        "Returns the sparse6 encoding of the graph as :class:`bytes`, without "
+        "a trailing newline. Vertex colors are not encoded. *perm* is "
+        "treated as in :meth:`~pybliss.Graph.to_graph6`.");
+  } else {
+    graph.def_static(
+        "from_digraph6",
+        [](nb::object data) {
+          return decode_graph<GraphT>(data, parse_digraph6);
+        },
+        "data"_a,
+        "Return the directed graph encoded in the digraph6 format in *data*, "
+        "a :class:`bytes` or :class:`str` object holding a single line. See "
+        "`formats.txt <https://users.cecs.anu.edu.au/~bdm/data/formats.txt>`_"
+        " for the definition of the format. All vertices have color 0.");
+    graph.def_static(
+        "iter_digraph6",
+        [](nb::object source) {
+          return std::make_unique<GraphIterator<GraphT>>(source,
+                                                         read_digraph6_graph)
+              .release();
+        },
+        "fp"_a,
+        "Return an iterator over the directed graphs in *fp*, which holds one "
+        "graph per line in the digraph6 format. The lines are parsed lazily, "
+        "one per iteration. *fp* accepts the same sources as "
+        ":meth:`~pybliss.Digraph.from_dimacs`.");
+    graph.def(
+        "to_digraph6",
+        [](GraphT &self, const std::optional<PermArray> &perm) {
+          return encode_graph(self, perm, encode_digraph6);
+        },
+        "perm"_a = nb::none(),
+        "Returns the digraph6 encoding of the graph as :class:`bytes`, "
+        "without a trailing newline. Vertex colors are not encoded. If "
+        "*perm* is given, the graph is encoded as if "
+        ":meth:`~pybliss.Digraph.permute` was applied to it first.");
+  }
   graph.def(
       "write_dimacs",
       [](GraphT &self, nb::object file_obj) {
@@ -276,7 +1252,7 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       [](GraphT &self) {
         const std::string dimacs_code = capture_string_written_to_file(
             [&](FILE *fp) { self.write_dimacs(fp); });
-        return nb::str(dimacs_code.c_str());
+        return nb::str(dimacs_code.data(), dimacs_code.size());
       },
       "Returns a :class:`str` corresponding to DIMACS format of the "
       "graph.\n\n");
@@ -304,12 +1280,88 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
       The check is perform in :math:`O(E)`, where :math:`E` is the number
       of edges in this graph.
       )");
+  graph.def(
+      "to_bytes",
+      [](GraphT &self) {
+        std::vector<uint8_t> data;
+        {
+          nb::gil_scoped_release release;
+          data = serialize_graph(self);
+        }
+        return nb::bytes(data.data(), data.size());
+      },
+      "Returns the graph, including its vertex colors and the options set "
+      "by :meth:`set_splitting_heuristic`, :meth:`set_failure_recording`, "
+      ":meth:`set_component_recursion` and :meth:`set_long_prune_activity`, "
+      "in a compact binary format as :class:`bytes`. The format is "
+      "versioned: the adjacency lists are stored as delta-coded varints, "
+      "duplicate edges are dropped. See :meth:`from_bytes` for the "
+      "inverse.");
+  graph.def_static(
+      "from_bytes",
+      [](const ByteArray &data) {
+        ParsedGraph parsed;
+        typename GraphAccess<GraphT>::SearchOptions options;
+        decode_bytes<GraphT>(data, parsed, options);
+        GraphT *g = graph_from_parsed<GraphT>(parsed);
+        GraphAccess<GraphT>::set_search_options(*g, options);
+        return g;
+      },
+      "data"_a,
+      "Returns the graph encoded by :meth:`to_bytes` in *data*, any "
+      "bytes-like object (e.g. :class:`bytes`, :class:`memoryview`, "
+      ":class:`pickle.PickleBuffer`). Raises :class:`RuntimeError` if *data* "
+      "is malformed, holds the other type of graph or was written in a "
+      "newer version of the format.");
+  graph.def(
+      "__getstate__",
+      [](nb::handle self) { return self.attr("to_bytes")(); },
+      "Returns :meth:`to_bytes`.");
+  graph.def(
+      "__setstate__",
+      [](GraphT &self, const ByteArray &state) {
+        ParsedGraph parsed;
+        typename GraphAccess<GraphT>::SearchOptions options;
+        decode_bytes<GraphT>(state, parsed, options);
+        new (&self) GraphT(parsed.nvertices);
+        GraphAccess<GraphT>::add_edges(self, parsed.edges.data(),
+                                       parsed.edges.size() / 2);
+        GraphAccess<GraphT>::set_colors(self, parsed.colors.data());
+        GraphAccess<GraphT>::set_search_options(self, options);
+      },
+      "state"_a, "Initializes the graph from the output of :meth:`to_bytes`.");
+  graph.def(
+      "__reduce_ex__",
+      [](nb::handle self, int protocol) {
+        std::vector<uint8_t> data;
+        {
+          nb::gil_scoped_release release;
+          data = serialize_graph(nb::cast<GraphT &>(self));
+        }
+        nb::object from_bytes = self.type().attr("from_bytes");
+        if (protocol < 5) {
+          return nb::make_tuple(
+              from_bytes,
+              nb::make_tuple(nb::bytes(data.data(), data.size())));
+        }
+        const size_t size = data.size();
+        nb::object buffer =
+            nb::module_::import_("pickle").attr("PickleBuffer")(
+                make_owned_ndarray(std::move(data), {size}));
+        return nb::make_tuple(from_bytes, nb::make_tuple(buffer));
+      },
+      "protocol"_a,
+      "Supports pickling the graph in the format of :meth:`to_bytes`. With "
+      "pickle protocol 5, the encoded graph is handed to :mod:`pickle` as a "
+      ":class:`pickle.PickleBuffer`, which can be transferred out-of-band "
+      "(see the *buffer_callback* argument of :func:`pickle.dumps`) without "
+      "being copied into the pickle stream.");
   graph.def(
       "to_dot",
       [](GraphT &self) {
         const std::string dot_code = capture_string_written_to_file(
             [&](FILE *fp) { self.write_dot(fp); });
-        return nb::str(dot_code.c_str());
+        return nb::str(dot_code.data(), dot_code.size());
       },
       "Returns a :class:`str` corresponding to graphviz format of the "
       "graph.\n\n");
@@ -319,7 +1371,8 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
         nb::module_ pytools_graphviz = nb::module_::import_("pytools.graphviz");
         const std::string dot_code = capture_string_written_to_file(
             [&](FILE *fp) { self.write_dot(fp); });
-        pytools_graphviz.attr("show_dot")(nb::str(dot_code.c_str()), output_to);
+        pytools_graphviz.attr("show_dot")(
+            nb::str(dot_code.data(), dot_code.size()), output_to);
       },
       "output_to"_a = nb::none(),
       "Visualize the graph.\n\n"
@@ -344,6 +1397,13 @@ bind_abstractgraph(nb::module_ &m, const char *class_name_in_python) {
             "comparing (for equality) their canonical versions, be sure to use "
             "the same splitting heuristics for both graphs.");
 
+  nb::class_<GraphIterator<GraphT>>(
+      graph, "GraphIterator",
+      "Iterator over the graphs of an input holding several graphs, see "
+      ":meth:`iter_dimacs`.")
+      .def("__iter__", [](nb::object self) { return self; })
+      .def("__next__", &GraphIterator<GraphT>::next);
+
   nb::enum_<typename GraphT::SplittingHeuristic>(graph, "SplittingHeuristic",
                                                  R"(
       Enum defining the splitting heuristics for graph canonicalization.
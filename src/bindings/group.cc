@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <nanobind/stl/optional.h>
+#include <optional>
+#include <pybliss_ext.h>
+#include <pybliss_parallel.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using GeneratorArray = nb::ndarray<uint32_t, nb::ndim<2>, nb::c_contig>;
+using ElementArray = nb::ndarray<uint32_t, nb::ndim<1>, nb::c_contig>;
+
+// {{{ PermutationGroup
+
+/**
+ * A permutation group on {0, ..., N-1} represented by a base and strong
+ * generating set, computed with the deterministic Schreier-Sims algorithm.
+ *
+ * Permutations are N-long arrays mapping every point to its image, and are
+ * composed left to right: (p * q)[v] = q[p[v]]. Every level of the
+ * stabilizer chain stores its transversal and the inverses of the
+ * transversal elements as flat arrays of orbit_size * N entries.
+ */
+class PermutationGroup {
+public:
+  struct Level {
+    uint32_t base_point;
+    /// Indices into strong_generators of the generators of this level.
+    std::vector<uint32_t> generators;
+    std::vector<uint32_t> orbit;
+    /// Position of every point in orbit, or -1 if not in the orbit.
+    std::vector<int32_t> orbit_index;
+    /// orbit.size() permutations, mapping base_point to orbit[i].
+    std::vector<uint32_t> transversal;
+    std::vector<uint32_t> inverse_transversal;
+  };
+
+  PermutationGroup(size_t degree, const uint32_t *generators,
+                   size_t ngenerators)
+      : degree(degree) {
+    for (size_t i = 0; i < ngenerators; ++i) {
+      const uint32_t *gen = generators + i * degree;
+      if (!is_identity(gen)) {
+        strong_generators.emplace_back(gen, gen + degree);
+      }
+    }
+    schreier_sims();
+  }
+
+  size_t get_degree() const { return degree; }
+  const std::vector<Level> &get_levels() const { return levels; }
+  const std::vector<std::vector<uint32_t>> &get_strong_generators() const {
+    return strong_generators;
+  }
+
+  /**
+   * Returns true if and only if \p perm, which must be a permutation, is in
+   * the group. \p scratch must hold 2N entries.
+   */
+  bool contains(const uint32_t *perm, uint32_t *scratch) const {
+    std::memcpy(scratch, perm, sizeof(uint32_t) * degree);
+    return sift(scratch, scratch + degree, 0) == levels.size() &&
+           is_identity(scratch);
+  }
+
+  /**
+   * Stores in \p out a uniformly random element of the group.
+   */
+  template <typename RNG> void random_element(RNG &rng, uint32_t *out) const {
+    std::vector<uint32_t> tmp(degree);
+    for (uint32_t v = 0; v < degree; ++v) {
+      out[v] = v;
+    }
+    for (size_t i = levels.size(); i-- > 0;) {
+      const Level &level = levels[i];
+      std::uniform_int_distribution<size_t> pick(0, level.orbit.size() - 1);
+      const uint32_t *u = &level.transversal[pick(rng) * degree];
+      for (uint32_t v = 0; v < degree; ++v) {
+        tmp[v] = u[out[v]];
+      }
+      std::memcpy(out, tmp.data(), sizeof(uint32_t) * degree);
+    }
+  }
+
+private:
+  size_t degree;
+  std::vector<std::vector<uint32_t>> strong_generators;
+  std::vector<Level> levels;
+
+  bool is_identity(const uint32_t *perm) const {
+    for (uint32_t v = 0; v < degree; ++v) {
+      if (perm[v] != v) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Sifts \p perm in place through the levels from \p first_level on, using
+   * \p tmp (N entries) as scratch. Returns the level at which the sifting
+   * dropped out, i.e. levels.size() if \p perm was sifted through the whole
+   * chain.
+   */
+  size_t sift(uint32_t *perm, uint32_t *tmp, size_t first_level) const {
+    for (size_t i = first_level; i < levels.size(); ++i) {
+      const Level &level = levels[i];
+      const int32_t j = level.orbit_index[perm[level.base_point]];
+      if (j < 0) {
+        return i;
+      }
+      const uint32_t *u_inv = &level.inverse_transversal[j * degree];
+      for (uint32_t v = 0; v < degree; ++v) {
+        tmp[v] = u_inv[perm[v]];
+      }
+      std::memcpy(perm, tmp, sizeof(uint32_t) * degree);
+    }
+    return levels.size();
+  }
+
+  /**
+   * Recomputes the orbit and transversal of \p level under its generators.
+   */
+  void compute_orbit(Level &level) {
+    level.orbit.assign(1, level.base_point);
+    level.orbit_index.assign(degree, -1);
+    level.orbit_index[level.base_point] = 0;
+    level.transversal.resize(degree);
+    for (uint32_t v = 0; v < degree; ++v) {
+      level.transversal[v] = v;
+    }
+    for (size_t i = 0; i < level.orbit.size(); ++i) {
+      const uint32_t beta = level.orbit[i];
+      for (uint32_t igen : level.generators) {
+        const uint32_t *s = strong_generators[igen].data();
+        const uint32_t image = s[beta];
+        if (level.orbit_index[image] >= 0) {
+          continue;
+        }
+        level.orbit_index[image] = level.orbit.size();
+        level.orbit.push_back(image);
+        // u_image = u_beta * s
+        const size_t offset = level.transversal.size();
+        level.transversal.resize(offset + degree);
+        const uint32_t *u_beta = &level.transversal[i * degree];
+        for (uint32_t v = 0; v < degree; ++v) {
+          level.transversal[offset + v] = s[u_beta[v]];
+        }
+      }
+    }
+    level.inverse_transversal.resize(level.transversal.size());
+    for (size_t i = 0; i < level.orbit.size(); ++i) {
+      const uint32_t *u = &level.transversal[i * degree];
+      uint32_t *u_inv = &level.inverse_transversal[i * degree];
+      for (uint32_t v = 0; v < degree; ++v) {
+        u_inv[u[v]] = v;
+      }
+    }
+  }
+
+  /**
+   * Appends a level whose base point is moved by \p perm.
+   */
+  void add_level(const uint32_t *perm) {
+    uint32_t b = 0;
+    while (perm[b] == b) {
+      ++b;
+    }
+    levels.emplace_back();
+    levels.back().base_point = b;
+  }
+
+  void add_strong_generator(std::vector<uint32_t> &&gen, size_t first_level,
+                            size_t last_level) {
+    strong_generators.push_back(std::move(gen));
+    for (size_t i = first_level; i <= last_level; ++i) {
+      levels[i].generators.push_back(strong_generators.size() - 1);
+      compute_orbit(levels[i]);
+    }
+  }
+
+  void schreier_sims() {
+    // Initial base: every generator must move some base point.
+    for (uint32_t igen = 0; igen < strong_generators.size(); ++igen) {
+      const uint32_t *s = strong_generators[igen].data();
+      bool moves_base = false;
+      for (const Level &level : levels) {
+        moves_base = moves_base || s[level.base_point] != level.base_point;
+      }
+      if (!moves_base) {
+        add_level(s);
+      }
+    }
+    for (size_t i = 0; i < levels.size(); ++i) {
+      for (uint32_t igen = 0; igen < strong_generators.size(); ++igen) {
+        const uint32_t *s = strong_generators[igen].data();
+        bool fixes_prefix = true;
+        for (size_t j = 0; j < i; ++j) {
+          fixes_prefix = fixes_prefix &&
+                         s[levels[j].base_point] == levels[j].base_point;
+        }
+        if (fixes_prefix) {
+          levels[i].generators.push_back(igen);
+        }
+      }
+      compute_orbit(levels[i]);
+    }
+
+    // Check that the Schreier generators of every level sift through the
+    // levels below it, from the deepest level up. A failing Schreier
+    // generator is added as a strong generator to the levels it reached,
+    // and the check resumes at the deepest of them.
+    size_t i = levels.size();
+    while (i > 0) {
+      if (std::optional<size_t> j = add_failing_schreier_generator(i - 1)) {
+        i = *j + 1;
+      } else {
+        --i;
+      }
+    }
+  }
+
+  /**
+   * Sifts the Schreier generators of \p ilevel through the levels below it.
+   * If one of them does not sift to the identity, adds what remains of it as
+   * a strong generator and returns the level at which it dropped out.
+   */
+  std::optional<size_t> add_failing_schreier_generator(size_t ilevel) {
+    const Level &level = levels[ilevel];
+    std::vector<uint32_t> h(degree), tmp(degree);
+    for (size_t ibeta = 0; ibeta < level.orbit.size(); ++ibeta) {
+      const uint32_t *u_beta = &level.transversal[ibeta * degree];
+      for (uint32_t igen : level.generators) {
+        const uint32_t *s = strong_generators[igen].data();
+        // h = u_beta * s * u_{beta^s}^-1
+        const uint32_t image = s[level.orbit[ibeta]];
+        const uint32_t *u_image_inv =
+            &level.inverse_transversal[level.orbit_index[image] * degree];
+        for (uint32_t v = 0; v < degree; ++v) {
+          h[v] = u_image_inv[s[u_beta[v]]];
+        }
+        const size_t j = sift(h.data(), tmp.data(), ilevel + 1);
+        if (j == levels.size()) {
+          if (is_identity(h.data())) {
+            continue;
+          }
+          add_level(h.data());
+        }
+        add_strong_generator(std::move(h), ilevel + 1, j);
+        return j;
+      }
+    }
+    return std::nullopt;
+  }
+};
+
+// }}}
+
+// {{{ bindings
+
+/**
+ * The group and the state of its random number generator, as exposed to
+ * Python.
+ */
+struct PyPermutationGroup {
+  std::unique_ptr<PermutationGroup> group;
+  std::mt19937_64 rng;
+};
+
+static void check_permutations(const uint32_t *perms, size_t nperms,
+                               size_t degree) {
+  std::vector<uint8_t> seen(degree);
+  for (size_t i = 0; i < nperms; ++i) {
+    std::fill(seen.begin(), seen.end(), 0);
+    for (size_t v = 0; v < degree; ++v) {
+      const uint32_t image = perms[i * degree + v];
+      if (image >= degree || seen[image]) {
+        throw std::runtime_error("Expected permutations of {0, ..., N-1}.");
+      }
+      seen[image] = 1;
+    }
+  }
+}
+
+static nb::ndarray<nb::numpy, uint32_t>
+permutations_to_ndarray(const uint32_t *const *perms, size_t nperms,
+                        size_t degree) {
+  std::unique_ptr<uint32_t[]> data(new uint32_t[nperms * degree]);
+  for (size_t i = 0; i < nperms; ++i) {
+    std::memcpy(&data[i * degree], perms[i], sizeof(uint32_t) * degree);
+  }
+  return make_owned_ndarray(data.release(), {nperms, degree});
+}
+
+void bind_group(nb::module_ &m) {
+  nb::class_<PyPermutationGroup>(m, "PermutationGroup", R"(
+    A permutation group on :math:`\{0, 1, \ldots, N-1\}` given by generators,
+    e.g. those returned by :meth:`Graph.automorphism_generators`. On
+    construction, a base and strong generating set is computed natively with
+    the deterministic Schreier-Sims algorithm, after which the group order,
+    membership tests and random elements are cheap.
+
+    Permutations are :class:`numpy.ndarray` s of dtype ``uint32`` mapping
+    every point to its image, as everywhere else in pybliss.
+
+    .. automethod:: __init__
+    .. autoattribute:: degree
+    .. autoattribute:: base
+    .. automethod:: order
+    .. automethod:: contains
+    .. automethod:: stabilizer_chain
+    .. automethod:: strong_generators
+    .. automethod:: random_element
+  )")
+      .def(
+          "__init__",
+          [](PyPermutationGroup *self, const GeneratorArray &generators,
+             std::optional<uint64_t> seed) {
+            const size_t ngenerators = generators.shape(0);
+            const size_t degree = generators.shape(1);
+            const uint32_t *data = (const uint32_t *)generators.data();
+            std::unique_ptr<PermutationGroup> group;
+            {
+              nb::gil_scoped_release release;
+              check_permutations(data, ngenerators, degree);
+              group = std::make_unique<PermutationGroup>(degree, data,
+                                                         ngenerators);
+            }
+            new (self) PyPermutationGroup{
+                std::move(group),
+                std::mt19937_64(seed ? *seed : std::random_device()())};
+          },
+          "generators"_a, "seed"_a = nb::none(),
+          "Creates the group generated by the rows of *generators*, a "
+          ":math:`(k, N)`-shaped array of permutations. *seed* seeds the "
+          "random number generator of :meth:`random_element`.")
+      .def_prop_ro(
+          "degree",
+          [](PyPermutationGroup &self) { return self.group->get_degree(); },
+          "The number of points :math:`N` the group acts on.")
+      .def_prop_ro(
+          "base",
+          [](PyPermutationGroup &self) {
+            const auto &levels = self.group->get_levels();
+            std::unique_ptr<uint32_t[]> base(new uint32_t[levels.size()]);
+            for (size_t i = 0; i < levels.size(); ++i) {
+              base[i] = levels[i].base_point;
+            }
+            return make_owned_ndarray(base.release(), {levels.size()});
+          },
+          "The base of the stabilizer chain as a ``uint32`` array: only the "
+          "identity fixes all of its points.")
+      .def(
+          "order",
+          [](PyPermutationGroup &self) {
+            nb::object order = nb::int_(1);
+            for (const auto &level : self.group->get_levels()) {
+              order = order * nb::int_(level.orbit.size());
+            }
+            return nb::borrow<nb::int_>(order);
+          },
+          "Returns the order of the group as an :class:`int`, the product "
+          "of the orbit sizes along the stabilizer chain.")
+      .def(
+          "contains",
+          [](PyPermutationGroup &self, const ElementArray &perm) {
+            const size_t degree = self.group->get_degree();
+            if (perm.shape(0) != degree) {
+              throw std::runtime_error("Permutation must have N entries.");
+            }
+            const uint32_t *data = (const uint32_t *)perm.data();
+            nb::gil_scoped_release release;
+            check_permutations(data, 1, degree);
+            std::vector<uint32_t> scratch(2 * degree);
+            return self.group->contains(data, scratch.data());
+          },
+          "perm"_a)
+      .def(
+          "contains",
+          [](PyPermutationGroup &self, const GeneratorArray &perms,
+             unsigned int n_threads) {
+            const size_t degree = self.group->get_degree();
+            const size_t nperms = perms.shape(0);
+            if (perms.shape(1) != degree) {
+              throw std::runtime_error("Permutations must have N entries.");
+            }
+            const uint32_t *data = (const uint32_t *)perms.data();
+            std::unique_ptr<bool[]> result(new bool[nperms]);
+            {
+              nb::gil_scoped_release release;
+              check_permutations(data, nperms, degree);
+              const unsigned int n_workers = resolve_n_threads(n_threads);
+              std::vector<uint32_t> scratch(2 * degree * n_workers);
+              parallel_for(nperms, n_workers,
+                           [&](size_t i, unsigned int worker) {
+                             result[i] = self.group->contains(
+                                 data + i * degree,
+                                 &scratch[2 * degree * worker]);
+                           });
+            }
+            return make_owned_ndarray(result.release(), {nperms});
+          },
+          "perms"_a, "n_threads"_a = 0,
+          "Returns *True* if and only if the permutation *perm* belongs to "
+          "the group.\n\n"
+          "Given a 2D array *perms* instead, tests every row and returns a "
+          "``bool`` array. The rows are sifted on *n_threads* native "
+          "threads (one per hardware thread by default) with the GIL "
+          "released.")
+      .def(
+          "stabilizer_chain",
+          [](PyPermutationGroup &self) {
+            const PermutationGroup &group = *self.group;
+            const auto &strong_generators = group.get_strong_generators();
+            const size_t degree = group.get_degree();
+            nb::list chain;
+            for (const auto &level : group.get_levels()) {
+              std::vector<const uint32_t *> gens;
+              for (uint32_t igen : level.generators) {
+                gens.push_back(strong_generators[igen].data());
+              }
+              std::unique_ptr<uint32_t[]> orbit(
+                  new uint32_t[level.orbit.size()]);
+              std::copy(level.orbit.begin(), level.orbit.end(), orbit.get());
+              chain.append(nb::make_tuple(
+                  level.base_point,
+                  make_owned_ndarray(orbit.release(), {level.orbit.size()}),
+                  permutations_to_ndarray(gens.data(), gens.size(), degree)));
+            }
+            return chain;
+          },
+          "Returns the stabilizer chain :math:`G = G_0 \\geq G_1 \\geq "
+          "\\ldots \\geq G_k = 1` as a list with a tuple ``(base_point, "
+          "orbit, generators)`` per level :math:`i`, where :math:`G_{i+1}` "
+          "is the stabilizer of *base_point* in :math:`G_i`, *orbit* is the "
+          "orbit of *base_point* under :math:`G_i` and *generators* is a "
+          ":math:`(k_i, N)` array of strong generators of :math:`G_i`.")
+      .def(
+          "strong_generators",
+          [](PyPermutationGroup &self) {
+            const auto &strong_generators =
+                self.group->get_strong_generators();
+            std::vector<const uint32_t *> gens;
+            for (const auto &gen : strong_generators) {
+              gens.push_back(gen.data());
+            }
+            return permutations_to_ndarray(gens.data(), gens.size(),
+                                           self.group->get_degree());
+          },
+          "Returns the strong generating set as a :math:`(k, N)` array. It "
+          "contains the non-identity input generators.")
+      .def(
+          "random_element",
+          [](PyPermutationGroup &self) {
+            const size_t degree = self.group->get_degree();
+            std::unique_ptr<uint32_t[]> element(new uint32_t[degree]);
+            self.group->random_element(self.rng, element.get());
+            return make_owned_ndarray(element.release(), {degree});
+          },
+          "Returns an element of the group drawn uniformly at random.");
+}
+
+// }}}
@@ -0,0 +1,712 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <nanobind/nanobind.h>
+#include <pybliss_io.h>
+#include <stdexcept>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// {{{ byte sources
+
+/**
+ * Bytes already in memory, owned by the Python object *owner*.
+ */
+class MemorySource : public ByteSource {
+public:
+  explicit MemorySource(nb::bytes owner)
+      : owner(owner), data(owner.c_str()), size(owner.size()) {}
+
+  bool next_chunk(const char *&chunk, size_t &chunk_size) override {
+    if (is_consumed || size == 0) {
+      return false;
+    }
+    is_consumed = true;
+    chunk = data;
+    chunk_size = size;
+    return true;
+  }
+
+private:
+  nb::bytes owner;
+  const char *data;
+  size_t size;
+  bool is_consumed = false;
+};
+
+/**
+ * Bytes of a Python stream, fetched by calling its ``read`` method. Text
+ * streams are encoded as UTF-8.
+ */
+class StreamSource : public ByteSource {
+public:
+  explicit StreamSource(nb::object stream) : read(stream.attr("read")) {}
+
+  bool next_chunk(const char *&data, size_t &size) override {
+    nb::gil_scoped_acquire acquire;
+    nb::object result = read(chunk_size);
+    if (nb::isinstance<nb::str>(result)) {
+      result = result.attr("encode")("utf-8");
+    }
+    chunk = nb::borrow<nb::bytes>(result);
+    if (chunk.size() == 0) {
+      return false;
+    }
+    data = chunk.c_str();
+    size = chunk.size();
+    return true;
+  }
+
+private:
+  static constexpr size_t chunk_size = 1 << 20;
+  nb::object read;
+  nb::bytes chunk;
+};
+
+#if !defined(_WIN32)
+/**
+ * Returns true only if \p fd is open on a regular file, whose size is known
+ * and which can be memory-mapped, as opposed to e.g. a pipe or a terminal.
+ */
+static bool is_regular_file(int fd) {
+  struct stat st;
+  return fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+/**
+ * A regular file mapped in memory, starting from byte *offset*.
+ */
+class MappedFileSource : public ByteSource {
+public:
+  MappedFileSource(int fd, size_t offset) : offset(offset) {
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      throw std::runtime_error("Failed to stat file.");
+    }
+    length = st.st_size;
+    if (length <= offset) {
+      return;
+    }
+    addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      addr = nullptr;
+      throw std::runtime_error("Failed to memory-map file.");
+    }
+    madvise(addr, length, MADV_SEQUENTIAL);
+  }
+
+  ~MappedFileSource() override {
+    if (addr) {
+      munmap(addr, length);
+    }
+  }
+
+  bool next_chunk(const char *&data, size_t &size) override {
+    if (is_consumed || !addr) {
+      return false;
+    }
+    is_consumed = true;
+    data = (const char *)addr + offset;
+    size = length - offset;
+    return true;
+  }
+
+private:
+  void *addr = nullptr;
+  size_t length = 0;
+  size_t offset;
+  bool is_consumed = false;
+};
+#endif
+
+/**
+ * Returns true only if \p obj is a binary Python file object, raw or
+ * buffered, that reads the bytes of its file descriptor unmodified, i.e.
+ * there is no decompression or other transcoding between the file
+ * descriptor and ``obj.read``, and whose ``tell`` is a byte offset. Text
+ * files are excluded, as their ``tell`` returns an opaque cookie.
+ */
+static bool is_plain_binary_file(nb::object obj) {
+  nb::module_ io = nb::module_::import_("io");
+  if (nb::isinstance(obj, io.attr("BufferedReader")) ||
+      nb::isinstance(obj, io.attr("BufferedRandom"))) {
+    obj = obj.attr("raw");
+  }
+  return nb::isinstance(obj, io.attr("FileIO"));
+}
+
+std::unique_ptr<ByteSource> open_byte_source(nb::object obj) {
+  nb::module_ builtins = nb::module_::import_("builtins");
+  nb::module_ os = nb::module_::import_("os");
+
+  if (nb::isinstance<nb::bytes>(obj)) {
+    return std::make_unique<MemorySource>(nb::borrow<nb::bytes>(obj));
+  }
+  if (nb::isinstance(obj, builtins.attr("bytearray")) ||
+      nb::isinstance(obj, builtins.attr("memoryview"))) {
+    return std::make_unique<MemorySource>(
+        nb::borrow<nb::bytes>(builtins.attr("bytes")(obj)));
+  }
+
+  if (nb::isinstance<nb::str>(obj) || nb::hasattr(obj, "__fspath__")) {
+#if defined(_WIN32)
+    return std::make_unique<StreamSource>(builtins.attr("open")(obj, "rb"));
+#else
+    nb::bytes path = nb::borrow<nb::bytes>(os.attr("fsencode")(obj));
+    // Named pipes, /dev/stdin and the like are read as streams. They are
+    // told apart before opening them, as opening a pipe twice could lose
+    // its writer.
+    struct stat st;
+    if (::stat(path.c_str(), &st) == 0 && !S_ISREG(st.st_mode)) {
+      return std::make_unique<StreamSource>(builtins.attr("open")(obj, "rb"));
+    }
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("Failed to open '") +
+                               path.c_str() + "'.");
+    }
+    try {
+      auto source = std::make_unique<MappedFileSource>(fd, 0);
+      close(fd); // The mapping outlives the file descriptor.
+      return source;
+    } catch (...) {
+      close(fd);
+      throw;
+    }
+#endif
+  }
+
+  if (!nb::hasattr(obj, "read")) {
+    throw std::runtime_error(
+        "Expected a path, a bytes-like object or a readable file-like "
+        "object.");
+  }
+
+#if !defined(_WIN32)
+  if (is_plain_binary_file(obj)) {
+    const int fd = nb::cast<int>(obj.attr("fileno")());
+    if (is_regular_file(fd)) {
+      const long offset = nb::cast<long>(obj.attr("tell")());
+      auto source = std::make_unique<MappedFileSource>(fd, offset);
+      // The mapping is read whole: leave the file where a read to the end
+      // would have.
+      obj.attr("seek")(0, os.attr("SEEK_END"));
+      return source;
+    }
+  }
+#endif
+  return std::make_unique<StreamSource>(obj);
+}
+
+bool LineReader::next_line(const char *&begin, const char *&end) {
+  if (is_put_back) {
+    is_put_back = false;
+    begin = line_begin;
+    end = line_end;
+    return true;
+  }
+  if (is_carry_returned) {
+    carry.clear();
+    is_carry_returned = false;
+  }
+
+  while (true) {
+    if (cur != chunk_end) {
+      const char *nl = (const char *)memchr(cur, '\n', chunk_end - cur);
+      if (nl) {
+        if (carry.empty()) {
+          line_begin = cur;
+          line_end = nl;
+        } else {
+          carry.append(cur, nl);
+          line_begin = carry.data();
+          line_end = line_begin + carry.size();
+          is_carry_returned = true;
+        }
+        cur = nl + 1;
+        break;
+      }
+      // The line continues in the next chunk, which invalidates this one.
+      carry.append(cur, chunk_end);
+      cur = chunk_end;
+    }
+
+    const char *data = nullptr;
+    size_t size = 0;
+    if (!is_exhausted && source->next_chunk(data, size)) {
+      cur = data;
+      chunk_end = data + size;
+      continue;
+    }
+    is_exhausted = true;
+    cur = chunk_end = nullptr;
+    if (carry.empty()) {
+      return false;
+    }
+    // Last line without a trailing newline.
+    line_begin = carry.data();
+    line_end = line_begin + carry.size();
+    is_carry_returned = true;
+    break;
+  }
+
+  if (line_end != line_begin && line_end[-1] == '\r') {
+    --line_end;
+  }
+  ++lineno;
+  begin = line_begin;
+  end = line_end;
+  return true;
+}
+
+// }}}
+
+// {{{ DIMACS
+
+static const char *skip_blanks(const char *p, const char *end) {
+  while (p != end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ * Parses the unsigned integer starting at the first non-blank character of
+ * [\p p, \p end) into \p value, and advances \p p past it. Returns false if
+ * there is no integer or if it does not fit in 32 bits.
+ */
+static bool scan_uint(const char *&p, const char *end, uint32_t &value) {
+  p = skip_blanks(p, end);
+  if (p == end || *p < '0' || *p > '9') {
+    return false;
+  }
+  uint64_t v = 0;
+  while (p != end && *p >= '0' && *p <= '9') {
+    v = 10 * v + (*p - '0');
+    if (v > UINT32_MAX) {
+      return false;
+    }
+    ++p;
+  }
+  value = (uint32_t)v;
+  return true;
+}
+
+static std::runtime_error dimacs_error(const LineReader &reader,
+                                       const std::string &msg) {
+  return std::runtime_error("Error while reading DIMACS at line " +
+                            std::to_string(reader.line_number()) + ": " + msg);
+}
+
+bool read_dimacs_graph(LineReader &reader, ParsedGraph &graph) {
+  const char *begin, *end, *p;
+
+  // Skip the comments up to the problem line.
+  while (true) {
+    if (!reader.next_line(begin, end)) {
+      return false;
+    }
+    begin = skip_blanks(begin, end);
+    if (begin != end && *begin != 'c') {
+      break;
+    }
+  }
+  uint32_t nvertices, nedges;
+  p = skip_blanks(begin + 1, end);
+  const bool is_problem_line =
+      *begin == 'p' && end - p >= 4 && std::strncmp(p, "edge", 4) == 0;
+  if (is_problem_line) {
+    p += 4;
+  }
+  if (!is_problem_line || !scan_uint(p, end, nvertices) ||
+      !scan_uint(p, end, nedges) || skip_blanks(p, end) != end) {
+    throw dimacs_error(reader, "expected a problem line 'p edge N E'.");
+  }
+
+  graph.nvertices = nvertices;
+  graph.colors.assign(nvertices, 0);
+  graph.edges.clear();
+  // Do not trust the header blindly with the allocation size.
+  graph.edges.reserve(2 * std::min<size_t>(nedges, 1 << 26));
+
+  while (reader.next_line(begin, end)) {
+    begin = skip_blanks(begin, end);
+    if (begin == end || *begin == 'c') {
+      continue;
+    }
+    if (*begin == 'p') {
+      // Problem line of the next graph.
+      reader.put_back();
+      break;
+    }
+
+    uint32_t v1, v2;
+    p = begin + 1;
+    if ((*begin != 'e' && *begin != 'n') || !scan_uint(p, end, v1) ||
+        !scan_uint(p, end, v2) || skip_blanks(p, end) != end) {
+      throw dimacs_error(reader, "ill-formed line '" +
+                                     std::string(begin, end) + "'.");
+    }
+    if (v1 == 0 || v1 > nvertices ||
+        (*begin == 'e' && (v2 == 0 || v2 > nvertices))) {
+      throw dimacs_error(reader, "vertex out of the range [1, " +
+                                     std::to_string(nvertices) + "].");
+    }
+    // DIMACS numbers the vertices from 1.
+    if (*begin == 'n') {
+      graph.colors[v1 - 1] = v2;
+    } else {
+      graph.edges.push_back(v1 - 1);
+      graph.edges.push_back(v2 - 1);
+    }
+  }
+
+  if (graph.edges.size() != 2 * (size_t)nedges) {
+    throw dimacs_error(reader, "expected " + std::to_string(nedges) +
+                                   " edges, found " +
+                                   std::to_string(graph.edges.size() / 2) +
+                                   ".");
+  }
+  return true;
+}
+
+// }}}
+
+// {{{ graph6, sparse6, digraph6
+
+// See <https://users.cecs.anu.edu.au/~bdm/data/formats.txt> for the
+// definition of the formats.
+
+static constexpr int BIAS6 = 63;
+
+static std::runtime_error graph6_error(const char *format,
+                                       const std::string &msg) {
+  return std::runtime_error(std::string("Error while reading ") + format +
+                            ": " + msg);
+}
+
+/**
+ * Skips the optional ``>>header<<`` prefix \p header of [\p p, \p end).
+ */
+static const char *skip_header(const char *p, const char *end,
+                               const char *header) {
+  const size_t len = std::strlen(header);
+  if ((size_t)(end - p) >= len && std::strncmp(p, header, len) == 0) {
+    return p + len;
+  }
+  return p;
+}
+
+/**
+ * Parses the vertex count N(n) starting at \p p and advances \p p past it.
+ */
+static uint32_t decode_nvertices(const char *&p, const char *end,
+                                 const char *format) {
+  if (p == end || *p < BIAS6 || *p > 126) {
+    throw graph6_error(format, "missing vertex count.");
+  }
+  if (*p != 126) {
+    return *p++ - BIAS6;
+  }
+  ++p;
+  int nbytes = 3;
+  if (p != end && *p == 126) {
+    ++p;
+    nbytes = 6;
+  }
+  if (end - p < nbytes) {
+    throw graph6_error(format, "truncated vertex count.");
+  }
+  uint64_t n = 0;
+  for (int i = 0; i < nbytes; ++i, ++p) {
+    if (*p < BIAS6 || *p > 126) {
+      throw graph6_error(format, "invalid character.");
+    }
+    n = (n << 6) | (uint64_t)(*p - BIAS6);
+  }
+  if (n > UINT32_MAX) {
+    throw graph6_error(format, "too many vertices.");
+  }
+  return (uint32_t)n;
+}
+
+static void encode_nvertices(std::string &out, uint32_t n) {
+  if (n <= 62) {
+    out.push_back(BIAS6 + n);
+    return;
+  }
+  int nbytes = 3;
+  out.push_back(126);
+  if (n > 258047) {
+    out.push_back(126);
+    nbytes = 6;
+  }
+  for (int i = nbytes - 1; i >= 0; --i) {
+    out.push_back(BIAS6 + ((uint64_t)n >> (6 * i) & 63));
+  }
+}
+
+/**
+ * Validates that [\p p, \p end) holds exactly the \p nbits bits of R(x) and
+ * returns the 6-bit groups with their bias removed.
+ */
+static std::vector<uint8_t> decode_bits(const char *p, const char *end,
+                                        uint64_t nbits, const char *format) {
+  if ((uint64_t)(end - p) != (nbits + 5) / 6) {
+    throw graph6_error(format, "unexpected length.");
+  }
+  std::vector<uint8_t> groups(end - p);
+  for (size_t i = 0; i < groups.size(); ++i) {
+    if (p[i] < BIAS6 || p[i] > 126) {
+      throw graph6_error(format, "invalid character.");
+    }
+    groups[i] = p[i] - BIAS6;
+  }
+  return groups;
+}
+
+static bool get_bit(const std::vector<uint8_t> &groups, uint64_t k) {
+  return (groups[k / 6] >> (5 - k % 6)) & 1;
+}
+
+static void set_bit(std::string &out, size_t offset, uint64_t k) {
+  out[offset + k / 6] |= 1 << (5 - k % 6);
+}
+
+/**
+ * Appends the \p nbits bits R(x), whose set bits are filled by \p set_bits,
+ * to \p out.
+ */
+template <typename F>
+static void encode_bits(std::string &out, uint64_t nbits, F &&set_bits) {
+  const size_t offset = out.size();
+  out.resize(offset + (nbits + 5) / 6, 0);
+  set_bits(offset);
+  for (size_t i = offset; i < out.size(); ++i) {
+    out[i] += BIAS6;
+  }
+}
+
+static void parse_graph6_body(const char *p, const char *end,
+                              ParsedGraph &graph) {
+  const uint32_t n = decode_nvertices(p, end, "graph6");
+  const std::vector<uint8_t> groups =
+      decode_bits(p, end, (uint64_t)n * (n - (n > 0)) / 2, "graph6");
+  graph.nvertices = n;
+  graph.colors.assign(n, 0);
+  graph.edges.clear();
+  uint64_t k = 0;
+  for (uint32_t j = 1; j < n; ++j) {
+    for (uint32_t i = 0; i < j; ++i, ++k) {
+      if (get_bit(groups, k)) {
+        graph.edges.push_back(i);
+        graph.edges.push_back(j);
+      }
+    }
+  }
+}
+
+static void parse_sparse6_body(const char *p, const char *end,
+                               ParsedGraph &graph) {
+  const uint32_t n = decode_nvertices(p, end, "sparse6");
+  graph.nvertices = n;
+  graph.colors.assign(n, 0);
+  graph.edges.clear();
+
+  // Number of bits needed to write n-1 in binary.
+  int k = 0;
+  while (k < 32 && ((uint64_t)1 << k) < n) {
+    ++k;
+  }
+
+  const uint64_t nbits = 6 * (uint64_t)(end - p);
+  const std::vector<uint8_t> groups =
+      decode_bits(p, end, nbits, "sparse6");
+  uint64_t ibit = 0;
+  uint64_t v = 0;
+  // An incomplete (b, x) pair at the end is padding.
+  while (ibit + 1 + k <= nbits) {
+    if (get_bit(groups, ibit++)) {
+      ++v;
+    }
+    uint64_t x = 0;
+    for (int i = 0; i < k; ++i) {
+      x = (x << 1) | get_bit(groups, ibit++);
+    }
+    if (x > v) {
+      v = x;
+    } else if (v < n) {
+      graph.edges.push_back(x);
+      graph.edges.push_back(v);
+    }
+  }
+}
+
+void parse_graph6(const char *begin, const char *end, ParsedGraph &graph) {
+  begin = skip_header(begin, end, ">>graph6<<");
+  begin = skip_header(begin, end, ">>sparse6<<");
+  if (begin != end && *begin == ':') {
+    parse_sparse6_body(begin + 1, end, graph);
+  } else if (begin != end && *begin == ';') {
+    throw graph6_error("sparse6", "incremental sparse6 is not supported.");
+  } else {
+    parse_graph6_body(begin, end, graph);
+  }
+}
+
+void parse_digraph6(const char *begin, const char *end, ParsedGraph &graph) {
+  begin = skip_header(begin, end, ">>digraph6<<");
+  if (begin == end || *begin != '&') {
+    throw graph6_error("digraph6", "expected a line starting with '&'.");
+  }
+  ++begin;
+  const uint32_t n = decode_nvertices(begin, end, "digraph6");
+  const std::vector<uint8_t> groups =
+      decode_bits(begin, end, (uint64_t)n * n, "digraph6");
+  graph.nvertices = n;
+  graph.colors.assign(n, 0);
+  graph.edges.clear();
+  uint64_t k = 0;
+  for (uint32_t i = 0; i < n; ++i) {
+    for (uint32_t j = 0; j < n; ++j, ++k) {
+      if (get_bit(groups, k)) {
+        graph.edges.push_back(i);
+        graph.edges.push_back(j);
+      }
+    }
+  }
+}
+
+/**
+ * Reads the next non-empty line of \p reader with \p parse_line. Returns
+ * false at the end of the input.
+ */
+static bool
+read_graph_line(LineReader &reader, ParsedGraph &graph,
+                void (*parse_line)(const char *, const char *, ParsedGraph &)) {
+  const char *begin, *end;
+  do {
+    if (!reader.next_line(begin, end)) {
+      return false;
+    }
+    begin = skip_blanks(begin, end);
+  } while (begin == end);
+
+  try {
+    parse_line(begin, end, graph);
+  } catch (const std::runtime_error &e) {
+    throw std::runtime_error(std::string(e.what()) + " (line " +
+                             std::to_string(reader.line_number()) + ")");
+  }
+  return true;
+}
+
+bool read_graph6_graph(LineReader &reader, ParsedGraph &graph) {
+  return read_graph_line(reader, graph, parse_graph6);
+}
+
+bool read_digraph6_graph(LineReader &reader, ParsedGraph &graph) {
+  return read_graph_line(reader, graph, parse_digraph6);
+}
+
+std::string encode_graph6(uint32_t nvertices,
+                          const std::vector<uint32_t> &edges) {
+  std::string out;
+  encode_nvertices(out, nvertices);
+  const uint64_t nbits =
+      (uint64_t)nvertices * (nvertices - (nvertices > 0)) / 2;
+  encode_bits(out, nbits, [&](size_t offset) {
+    for (size_t i = 0; i < edges.size(); i += 2) {
+      const uint64_t u = std::min(edges[i], edges[i + 1]);
+      const uint64_t v = std::max(edges[i], edges[i + 1]);
+      if (u == v) {
+        throw std::runtime_error(
+            "graph6 cannot represent self-loops, use sparse6 instead.");
+      }
+      set_bit(out, offset, v * (v - 1) / 2 + u);
+    }
+  });
+  return out;
+}
+
+std::string encode_sparse6(uint32_t nvertices,
+                           const std::vector<uint32_t> &edges) {
+  // Sort the edges {i, j}, i <= j, by j and then by i.
+  std::vector<uint64_t> sorted_edges(edges.size() / 2);
+  for (size_t i = 0; i < sorted_edges.size(); ++i) {
+    const uint64_t u = std::min(edges[2 * i], edges[2 * i + 1]);
+    const uint64_t v = std::max(edges[2 * i], edges[2 * i + 1]);
+    sorted_edges[i] = (v << 32) | u;
+  }
+  std::sort(sorted_edges.begin(), sorted_edges.end());
+
+  int k = 0;
+  while (k < 32 && ((uint64_t)1 << k) < nvertices) {
+    ++k;
+  }
+
+  std::string out(1, ':');
+  encode_nvertices(out, nvertices);
+
+  unsigned int acc = 0;
+  int nbits = 0;
+  auto put = [&](uint64_t value, int width) {
+    for (int b = width - 1; b >= 0; --b) {
+      acc = (acc << 1) | ((value >> b) & 1);
+      if (++nbits == 6) {
+        out.push_back(BIAS6 + acc);
+        acc = 0;
+        nbits = 0;
+      }
+    }
+  };
+
+  uint64_t lastj = 0;
+  for (uint64_t e : sorted_edges) {
+    const uint64_t i = e & UINT32_MAX, j = e >> 32;
+    if (j == lastj) {
+      put(0, 1);
+    } else {
+      put(1, 1);
+      if (j > lastj + 1) {
+        put(j, k);
+        put(0, 1);
+      }
+      lastj = j;
+    }
+    put(i, k);
+  }
+
+  if (nbits != 0) {
+    int npad = 6 - nbits;
+    // Padding with 1-bits could be read as an extra edge {n-1, n-1} in this
+    // case, a 0-bit prefix avoids it.
+    if (npad >= k + 1 && lastj + 2 == nvertices &&
+        ((uint64_t)1 << k) == nvertices) {
+      put(0, 1);
+      --npad;
+    }
+    put((1u << npad) - 1, npad);
+  }
+  return out;
+}
+
+std::string encode_digraph6(uint32_t nvertices,
+                            const std::vector<uint32_t> &edges) {
+  std::string out(1, '&');
+  encode_nvertices(out, nvertices);
+  encode_bits(out, (uint64_t)nvertices * nvertices, [&](size_t offset) {
+    for (size_t i = 0; i < edges.size(); i += 2) {
+      set_bit(out, offset, (uint64_t)edges[i] * nvertices + edges[i + 1]);
+    }
+  });
+  return out;
+}
+
+// }}}
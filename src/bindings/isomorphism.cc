@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <array>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <optional>
+#include <pybliss_certificate.h>
+#include <pybliss_ext.h>
+#include <pybliss_graph_access.h>
+#include <pybliss_refinement.h>
+#include <vector>
+
+using namespace bliss;
+
+/**
+ * Returns the sorted (color, out-degree, in-degree) triples of the vertices
+ * of \p g, the in-degree being 0 for a Graph. \p g must be normalized.
+ */
+template <typename GraphT>
+static std::vector<std::array<uint32_t, 3>> degree_sequence(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  std::vector<std::array<uint32_t, 3>> sequence;
+  for (const auto &vertex : Access::vertices_of(g)) {
+    uint32_t in_degree = 0;
+    if constexpr (Access::is_directed) {
+      in_degree = vertex.edges_in.size();
+    }
+    sequence.push_back({vertex.color,
+                        (uint32_t)Access::out_edges(vertex).size(),
+                        in_degree});
+  }
+  std::sort(sequence.begin(), sequence.end());
+  return sequence;
+}
+
+/**
+ * Returns an isomorphism from \p g1 to \p g2 as the image in \p g2 of every
+ * vertex of \p g1, or an empty vector if the graphs are not isomorphic. Runs
+ * the bliss searches only if the graphs have the same colored degree
+ * sequences and color refinement does not tell them apart. May be called
+ * without the GIL.
+ */
+template <typename GraphT>
+static std::optional<std::vector<uint32_t>> find_isomorphism(GraphT &g1,
+                                                             GraphT &g2) {
+  using Access = GraphAccess<GraphT>;
+  const unsigned int nvertices = g1.get_nof_vertices();
+  if (g2.get_nof_vertices() != nvertices) {
+    return std::nullopt;
+  }
+  if (&g1 == &g2) {
+    std::vector<uint32_t> identity(nvertices);
+    for (unsigned int v = 0; v < nvertices; ++v) {
+      identity[v] = v;
+    }
+    return identity;
+  }
+
+  Access::normalize(g1);
+  Access::normalize(g2);
+  if (degree_sequence(g1) != degree_sequence(g2)) {
+    return std::nullopt;
+  }
+  std::vector<uint32_t> colors;
+  if (!(refine_colors(g1, colors) == refine_colors(g2, colors))) {
+    return std::nullopt;
+  }
+
+  // Canonical forms are comparable only if both searches use the same
+  // options, as all of them may change the canonical labeling.
+  std::unique_ptr<GraphT> g2_copy;
+  GraphT *searched2 = &g2;
+  if (Access::get_search_options(g1) != Access::get_search_options(g2)) {
+    g2_copy.reset(g2.copy());
+    Access::copy_search_options(g1, *g2_copy);
+    searched2 = g2_copy.get();
+  }
+
+  Stats stats;
+  const unsigned int *perm = g1.canonical_form(stats);
+  const std::vector<uint32_t> perm1(perm, perm + nvertices);
+  perm = searched2->canonical_form(stats);
+  const std::vector<uint32_t> perm2(perm, perm + nvertices);
+  if (make_certificate(g1, perm1.data()) !=
+      make_certificate(*searched2, perm2.data())) {
+    return std::nullopt;
+  }
+
+  // perm1 and perm2 both map onto the canonical form: v in g1 corresponds to
+  // the vertex of g2 that perm2 maps to perm1[v].
+  std::vector<uint32_t> inverse2(nvertices), isomorphism(nvertices);
+  for (unsigned int v = 0; v < nvertices; ++v) {
+    inverse2[perm2[v]] = v;
+  }
+  for (unsigned int v = 0; v < nvertices; ++v) {
+    isomorphism[v] = inverse2[perm1[v]];
+  }
+  return isomorphism;
+}
+
+template <typename GraphT>
+static nb::object are_isomorphic(GraphT &g1, GraphT &g2) {
+  std::optional<std::vector<uint32_t>> isomorphism;
+  {
+    nb::gil_scoped_release release;
+    isomorphism = find_isomorphism(g1, g2);
+  }
+  if (!isomorphism) {
+    return nb::none();
+  }
+  const size_t nvertices = isomorphism->size();
+  return nb::cast(make_owned_ndarray(std::move(*isomorphism), {nvertices}));
+}
+
+static const char *are_isomorphic_doc =
+    "Returns an isomorphism from *g1* to *g2*, two :class:`Graph` or two "
+    ":class:`Digraph`, as a :class:`numpy.ndarray` of dtype ``uint32`` "
+    "whose entry ``v`` is the vertex of *g2* that the vertex ``v`` of *g1* "
+    "is mapped to, so that ``g1.permute(iso)`` equals *g2*. Returns *None* "
+    "if the graphs are not isomorphic.\n\n"
+    "The checks go from cheap to expensive, stopping at the first that "
+    "tells the graphs apart: the numbers of vertices, the sorted (color, "
+    "out-degree, in-degree) triples of the vertices, the in-degree being 0 "
+    "for a :class:`Graph`, the hashes of "
+    ":meth:`Graph.refinement_invariant`, and finally the canonical forms of "
+    "both graphs, which are compared in place, without building permuted "
+    "graphs. If *g2* does not use the search options of *g1* (the splitting "
+    "heuristic, failure recording, component recursion and long prune), it "
+    "is searched as a copy that does. The GIL is released throughout.";
+
+void bind_isomorphism(nb::module_ &m) {
+  m.def("are_isomorphic", &are_isomorphic<Graph>, "g1"_a, "g2"_a,
+        are_isomorphic_doc);
+  m.def("are_isomorphic", &are_isomorphic<Digraph>, "g1"_a, "g2"_a,
+        are_isomorphic_doc);
+}
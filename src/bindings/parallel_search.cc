@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <atomic>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <bliss/stats.hh>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <pybliss_certificate.h>
+#include <pybliss_graph_access.h>
+#include <pybliss_parallel.h>
+#include <pybliss_parallel_search.h>
+#include <pybliss_refinement.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace bliss;
+
+/**
+ * Union-find over the vertices, merged along automorphisms, that also
+ * tracks which orbits contain the vertex of an already searched branch.
+ */
+class OrbitPartition {
+public:
+  explicit OrbitPartition(size_t n)
+      : parent(n), size(n, 1), is_marked(n, false) {
+    for (size_t v = 0; v < n; ++v) {
+      parent[v] = v;
+    }
+  }
+
+  uint32_t find(uint32_t v) {
+    while (parent[v] != v) {
+      parent[v] = parent[parent[v]];
+      v = parent[v];
+    }
+    return v;
+  }
+
+  void merge(uint32_t a, uint32_t b) {
+    a = find(a);
+    b = find(b);
+    if (a == b) {
+      return;
+    }
+    if (size[a] < size[b]) {
+      std::swap(a, b);
+    }
+    parent[b] = a;
+    size[a] += size[b];
+    is_marked[a] = is_marked[a] || is_marked[b];
+  }
+
+  void merge_along(const unsigned int *aut) {
+    for (uint32_t v = 0; v < parent.size(); ++v) {
+      if (aut[v] != v) {
+        merge(v, aut[v]);
+      }
+    }
+  }
+
+  void mark(uint32_t v) { is_marked[find(v)] = true; }
+  bool marked(uint32_t v) { return is_marked[find(v)]; }
+  uint32_t orbit_size(uint32_t v) { return size[find(v)]; }
+
+private:
+  std::vector<uint32_t> parent;
+  std::vector<uint32_t> size;
+  std::vector<bool> is_marked;
+};
+
+/**
+ * Returns the number of cells of \p colors to which the vertices of the cell
+ * of \p v are non-trivially connected, i.e. in which they have some but not
+ * all of the vertices as neighbors, as bliss counts them for its shs_fm,
+ * shs_fsm and shs_flm heuristics. \p colors must be equitable, so that any
+ * vertex of the cell gives the same count. \p count must hold a 0 for every
+ * color and is left so.
+ */
+template <typename GraphT>
+static uint32_t count_non_trivial_connections(
+    const GraphT &g, uint32_t v, const std::vector<uint32_t> &colors,
+    const std::vector<uint32_t> &cell_sizes, std::vector<uint32_t> &count) {
+  using Access = GraphAccess<GraphT>;
+  const auto &vertex = Access::vertices_of(g)[v];
+  uint32_t n_connections = 0;
+  auto count_in = [&](const std::vector<unsigned int> &neighbors) {
+    for (unsigned int w : neighbors) {
+      ++count[colors[w]];
+    }
+    for (unsigned int w : neighbors) {
+      const uint32_t color = colors[w];
+      if (count[color] != 0) {
+        n_connections += count[color] < cell_sizes[color];
+        count[color] = 0;
+      }
+    }
+  };
+  if constexpr (Access::is_directed) {
+    count_in(vertex.edges_out);
+    count_in(vertex.edges_in);
+  } else {
+    count_in(vertex.edges);
+  }
+  return n_connections;
+}
+
+/**
+ * Returns the vertices of the target cell in increasing order: the cell with
+ * at least two vertices of the equitable partition that color refinement
+ * computes from the vertex colors, chosen by the splitting heuristic of \p g
+ * as bliss chooses among the cells of its partition. "First" refers to the
+ * order of the refined colors, which are numbered canonically, so that the
+ * choice only depends on the isomorphism class of \p g. Returns an empty
+ * vector if refinement distinguishes all the vertices.
+ */
+template <typename GraphT>
+static std::vector<uint32_t> find_target_cell(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  std::vector<uint32_t> colors;
+  refine_colors(g, colors);
+  const uint32_t ncolors =
+      colors.empty() ? 0 : *std::max_element(colors.begin(), colors.end()) + 1;
+  std::vector<uint32_t> cell_sizes(ncolors, 0), representative(ncolors);
+  for (uint32_t v = colors.size(); v-- > 0;) {
+    ++cell_sizes[colors[v]];
+    representative[colors[v]] = v;
+  }
+
+  const auto heuristic = Access::get_search_options(g).splitting_heuristic;
+  // The sizes among which the first cell is taken, 0 for any.
+  uint32_t wanted_size = 0;
+  if (heuristic == GraphT::shs_fs || heuristic == GraphT::shs_fsm ||
+      heuristic == GraphT::shs_fl || heuristic == GraphT::shs_flm) {
+    const bool smallest =
+        heuristic == GraphT::shs_fs || heuristic == GraphT::shs_fsm;
+    for (uint32_t size : cell_sizes) {
+      if (size >= 2 && (wanted_size == 0 || (smallest ? size < wanted_size
+                                                      : size > wanted_size))) {
+        wanted_size = size;
+      }
+    }
+  }
+  const bool most_connected = heuristic == GraphT::shs_fm ||
+                              heuristic == GraphT::shs_fsm ||
+                              heuristic == GraphT::shs_flm;
+
+  std::optional<uint32_t> target;
+  uint32_t target_connections = 0;
+  std::vector<uint32_t> count(most_connected ? ncolors : 0, 0);
+  for (uint32_t color = 0; color < ncolors; ++color) {
+    const uint32_t size = cell_sizes[color];
+    if (size < 2 || (wanted_size != 0 && size != wanted_size)) {
+      continue;
+    }
+    if (!most_connected) {
+      target = color;
+      break;
+    }
+    const uint32_t connections = count_non_trivial_connections(
+        g, representative[color], colors, cell_sizes, count);
+    if (!target || connections > target_connections) {
+      target = color;
+      target_connections = connections;
+    }
+  }
+
+  std::vector<uint32_t> cell;
+  if (target) {
+    for (uint32_t v = 0; v < colors.size(); ++v) {
+      if (colors[v] == *target) {
+        cell.push_back(v);
+      }
+    }
+  }
+  return cell;
+}
+
+/**
+ * The outcome of the search of one branch.
+ */
+struct BranchResult {
+  enum { pending, pruned, searched } state = pending;
+  Stats stats;
+  std::vector<unsigned int> labeling;
+  std::string certificate;
+  /// Generators of the stabilizer of the branching vertex, flattened.
+  std::vector<unsigned int> generators;
+};
+
+template <typename GraphT>
+void parallel_search(GraphT &g, bool canonical, unsigned int n_threads,
+                     SearchMonitor &monitor, PyStats &stats,
+                     SearchContext &context) {
+  using Access = GraphAccess<GraphT>;
+  const unsigned int nvertices = g.get_nof_vertices();
+  Access::normalize(g);
+  const std::vector<uint32_t> cell = find_target_cell(g);
+  const auto report = monitor.report();
+  const auto terminate = monitor.terminate();
+  context.labeling.clear();
+
+  if (cell.empty()) {
+    // Refinement distinguishes every vertex, so bliss's search does not
+    // branch either: searching the branches would only repeat it.
+    if (canonical) {
+      const unsigned int *perm = g.canonical_form(stats, report, terminate);
+      context.labeling.assign(perm, perm + nvertices);
+    } else {
+      g.find_automorphisms(stats, report, terminate);
+    }
+    return;
+  }
+
+  unsigned int individual_color = 0;
+  for (unsigned int v = 0; v < nvertices; ++v) {
+    individual_color = std::max(individual_color, g.get_color(v) + 1);
+  }
+
+  std::vector<BranchResult> results(cell.size());
+  OrbitPartition orbits(nvertices);
+  std::unordered_map<std::string, size_t> first_with_certificate;
+  std::optional<size_t> best;
+  std::vector<unsigned int> automorphism(nvertices), inverse(nvertices);
+  PyStats::Combined combined;
+  size_t n_committed = 0;
+  std::mutex mutex;
+
+  auto emit_generator = [&](const unsigned int *aut) {
+    ++combined.n_generators;
+    if (report) {
+      report(nvertices, aut);
+    }
+  };
+
+  // Processes the results in branch order, as far as they are available.
+  // Called with the mutex held.
+  auto commit = [&]() {
+    for (; n_committed < cell.size(); ++n_committed) {
+      BranchResult &result = results[n_committed];
+      if (result.state == BranchResult::pending) {
+        break;
+      }
+      const uint32_t w = cell[n_committed];
+      if (result.state == BranchResult::pruned || orbits.marked(w)) {
+        result = BranchResult();
+        result.state = BranchResult::pruned;
+        continue;
+      }
+      orbits.mark(w);
+      combined.add(result.stats);
+      // Every automorphism that merges orbits is emitted: the later
+      // branches may be pruned through it, so the emitted generators must
+      // include it to generate the whole group.
+      for (size_t i = 0; i < result.generators.size(); i += nvertices) {
+        const unsigned int *aut = &result.generators[i];
+        orbits.merge_along(aut);
+        emit_generator(aut);
+      }
+      if (n_committed == 0) {
+        combined.group_size = result.stats.get_group_size();
+        combined.group_size_approx = result.stats.get_group_size_approx();
+      }
+      result.generators.clear();
+      result.generators.shrink_to_fit();
+
+      auto [it, inserted] =
+          first_with_certificate.emplace(result.certificate, n_committed);
+      if (!inserted) {
+        // Both branches lead to the same canonical graph: composing their
+        // labelings gives an automorphism mapping w to the other vertex.
+        const std::vector<unsigned int> &other = results[it->second].labeling;
+        for (unsigned int v = 0; v < nvertices; ++v) {
+          inverse[other[v]] = v;
+        }
+        for (unsigned int v = 0; v < nvertices; ++v) {
+          automorphism[v] = inverse[result.labeling[v]];
+        }
+        orbits.merge_along(automorphism.data());
+        emit_generator(automorphism.data());
+        result.labeling.clear();
+        result.labeling.shrink_to_fit();
+      } else if (canonical &&
+                 (!best || result.certificate < results[*best].certificate)) {
+        best = n_committed;
+      }
+      if (!canonical || best != n_committed) {
+        result.certificate.clear();
+        result.certificate.shrink_to_fit();
+      }
+    }
+  };
+
+  // The branches are handed out through work stealing. Every worker
+  // searches its branches on a copy of g of its own, made on its first
+  // branch.
+  const unsigned int n_workers =
+      std::min<size_t>(resolve_n_threads(n_threads), cell.size());
+  std::vector<std::unique_ptr<GraphT>> copies(n_workers);
+  if (context.branch_scratch.size() < n_workers) {
+    context.branch_scratch.resize(n_workers);
+  }
+  parallel_for(cell.size(), n_threads, [&](size_t ibranch,
+                                           unsigned int worker) {
+    if (monitor.is_stopped()) {
+      return;
+    }
+    const uint32_t w = cell[ibranch];
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (orbits.marked(w)) {
+        results[ibranch].state = BranchResult::pruned;
+        commit();
+        return;
+      }
+    }
+
+    std::unique_ptr<GraphT> &copy = copies[worker];
+    if (!copy) {
+      copy.reset(g.copy());
+      Access::copy_search_options(g, *copy);
+    }
+    BranchResult result;
+    const unsigned int color = copy->get_color(w);
+    copy->change_color(w, individual_color);
+    const unsigned int *perm = copy->canonical_form(
+        result.stats,
+        [&result](unsigned int n, const unsigned int *aut) {
+          result.generators.insert(result.generators.end(), aut, aut + n);
+        },
+        terminate);
+    result.labeling.assign(perm, perm + nvertices);
+    make_certificate(*copy, perm, context.branch_scratch[worker],
+                     result.certificate);
+    copy->change_color(w, color);
+    result.state = BranchResult::searched;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    results[ibranch] = std::move(result);
+    commit();
+  });
+
+  const uint32_t orbit_size = orbits.orbit_size(cell[0]);
+  combined.group_size.multiply(orbit_size);
+  combined.group_size_approx *= orbit_size;
+  combined.max_level += 1;
+  stats.combined = combined;
+
+  if (canonical && best) {
+    const std::vector<unsigned int> &labeling = results[*best].labeling;
+    context.labeling.assign(labeling.begin(), labeling.end());
+  }
+}
+
+template <typename GraphT>
+void portfolio_search(
+    GraphT &g,
+    const std::vector<typename GraphT::SplittingHeuristic> &heuristics,
+    SearchMonitor &monitor, PyStats &stats) {
+  using Access = GraphAccess<GraphT>;
+  const unsigned int nvertices = g.get_nof_vertices();
+  const size_t n_racers = heuristics.size();
+  const std::optional<uint64_t> max_generators =
+      monitor.get_limits().max_generators;
+  const auto terminate = monitor.terminate();
+
+  std::vector<Stats> racer_stats(n_racers);
+  std::vector<std::vector<unsigned int>> racer_generators(n_racers);
+  std::atomic<size_t> winner(n_racers);
+
+  parallel_for(n_racers, n_racers, [&](size_t iracer, unsigned int) {
+    std::vector<unsigned int> &generators = racer_generators[iracer];
+    // Another search may have won before this one even started.
+    if (winner.load(std::memory_order_relaxed) != n_racers) {
+      return;
+    }
+    std::unique_ptr<GraphT> copy(g.copy());
+    Access::copy_search_options(g, *copy);
+    copy->set_splitting_heuristic(heuristics[iracer]);
+    copy->find_automorphisms(
+        racer_stats[iracer],
+        [&generators](unsigned int n, const unsigned int *aut) {
+          generators.insert(generators.end(), aut, aut + n);
+        },
+        [&]() {
+          if (winner.load(std::memory_order_relaxed) != n_racers) {
+            return true;
+          }
+          if (max_generators && nvertices &&
+              generators.size() / nvertices >= *max_generators) {
+            return monitor.stop("max_generators");
+          }
+          return terminate && terminate();
+        });
+    size_t expected = n_racers;
+    winner.compare_exchange_strong(expected, iracer);
+  });
+
+  const size_t iwinner = winner.load();
+  static_cast<Stats &>(stats) = racer_stats[iwinner];
+  stats.portfolio_winner = iwinner;
+  if (const auto report = monitor.report()) {
+    const std::vector<unsigned int> &generators = racer_generators[iwinner];
+    for (size_t i = 0; i < generators.size(); i += nvertices) {
+      report(nvertices, &generators[i]);
+    }
+  }
+}
+
+template void parallel_search<Graph>(Graph &, bool, unsigned int,
+                                    SearchMonitor &, PyStats &,
+                                    SearchContext &);
+template void parallel_search<Digraph>(Digraph &, bool, unsigned int,
+                                      SearchMonitor &, PyStats &,
+                                      SearchContext &);
+template void portfolio_search<Graph>(
+    Graph &, const std::vector<Graph::SplittingHeuristic> &, SearchMonitor &,
+    PyStats &);
+template void portfolio_search<Digraph>(
+    Digraph &, const std::vector<Digraph::SplittingHeuristic> &,
+    SearchMonitor &, PyStats &);
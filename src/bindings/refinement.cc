@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <deque>
+#include <numeric>
+#include <pybliss_refinement.h>
+
+using namespace bliss;
+
+namespace {
+
+/**
+ * The words describing the refinement, hashed in chunks so that the memory
+ * does not grow with the number of splits. Every chunk is hashed with the
+ * hash of the previous chunks in front of it.
+ */
+class InvariantStream {
+public:
+  void push(uint32_t word) {
+    words.push_back(word);
+    if (words.size() >= chunk_size) {
+      flush();
+    }
+  }
+
+  Hash128 finish() {
+    flush();
+    return murmur3_128(words.data(), words.size() * sizeof(uint32_t));
+  }
+
+private:
+  void flush() {
+    const Hash128 hash =
+        murmur3_128(words.data(), words.size() * sizeof(uint32_t));
+    words.assign({(uint32_t)hash.lo, (uint32_t)(hash.lo >> 32),
+                  (uint32_t)hash.hi, (uint32_t)(hash.hi >> 32)});
+  }
+
+  static constexpr size_t chunk_size = 1 << 12;
+  std::vector<uint32_t> words;
+};
+
+/**
+ * An ordered partition of the vertices: every cell is a range of
+ * *elements* and is identified by its first position. The cells only ever
+ * split, a split cell keeping its first position, and the pieces are laid
+ * out in an order that only depends on the counts they were split by, so
+ * that the positions are invariant under isomorphisms.
+ */
+class OrderedPartition {
+public:
+  std::vector<uint32_t> elements;
+  std::vector<uint32_t> position;
+  std::vector<uint32_t> cell_of;
+  /// The size of every cell, indexed by its first position.
+  std::vector<uint32_t> cell_size;
+
+  explicit OrderedPartition(uint32_t nvertices)
+      : elements(nvertices), position(nvertices), cell_of(nvertices),
+        cell_size(nvertices, 0), count(nvertices, 0),
+        ntouched(nvertices, 0), is_queued(nvertices, false) {}
+
+  void queue_cell(uint32_t cell) {
+    if (!is_queued[cell]) {
+      is_queued[cell] = true;
+      queue.push_back(cell);
+    }
+  }
+
+  /**
+   * Removes the next splitter from the queue and stores its vertices in
+   * \p splitter. Returns false if the queue is empty.
+   */
+  bool pop_splitter(std::vector<uint32_t> &splitter) {
+    if (queue.empty()) {
+      return false;
+    }
+    const uint32_t cell = queue.front();
+    queue.pop_front();
+    is_queued[cell] = false;
+    splitter.assign(elements.begin() + cell,
+                    elements.begin() + cell + cell_size[cell]);
+    return true;
+  }
+
+  /**
+   * Splits every cell by the number of neighbors that its vertices have in
+   * \p splitter, where \p neighbors(u) lists the vertices that count u as a
+   * neighbor. Only the cells of these vertices are visited.
+   */
+  template <typename Neighbors>
+  void split_by(const std::vector<uint32_t> &splitter, Neighbors neighbors,
+                InvariantStream &stream) {
+    for (uint32_t u : splitter) {
+      for (unsigned int w : neighbors(u)) {
+        if (count[w]++ == 0) {
+          // Move w to the end of the untouched part of its cell.
+          const uint32_t cell = cell_of[w];
+          if (ntouched[cell]++ == 0) {
+            touched_cells.push_back(cell);
+          }
+          const uint32_t last = cell + cell_size[cell] - ntouched[cell];
+          const uint32_t other = elements[last];
+          std::swap(elements[position[w]], elements[last]);
+          position[other] = position[w];
+          position[w] = last;
+        }
+      }
+    }
+    std::sort(touched_cells.begin(), touched_cells.end());
+    stream.push(touched_cells.size());
+    for (uint32_t cell : touched_cells) {
+      split_cell(cell, stream);
+    }
+    touched_cells.clear();
+  }
+
+private:
+  /**
+   * Splits \p cell, whose last ntouched[cell] vertices have neighbors in the
+   * splitter: the untouched vertices stay first, followed by the touched
+   * ones by increasing count. Queues the new cells.
+   */
+  void split_cell(uint32_t cell, InvariantStream &stream) {
+    const uint32_t size = cell_size[cell];
+    const uint32_t begin = cell + size - ntouched[cell];
+    const uint32_t end = cell + size;
+    ntouched[cell] = 0;
+    std::sort(elements.begin() + begin, elements.begin() + end,
+              [this](uint32_t v, uint32_t w) { return count[v] < count[w]; });
+    stream.push(cell);
+    stream.push(size);
+    stream.push(end - begin);
+
+    // The pieces as [start, start + size) ranges.
+    pieces.clear();
+    if (begin > cell) {
+      pieces.push_back(cell);
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+      position[elements[i]] = i;
+      if (i == begin || count[elements[i]] != count[elements[i - 1]]) {
+        pieces.push_back(i);
+        stream.push(count[elements[i]]);
+      }
+    }
+    for (uint32_t i = begin; i < end; ++i) {
+      count[elements[i]] = 0;
+    }
+    pieces.push_back(end);
+    if (pieces.size() == 2) {
+      return;
+    }
+
+    // A cell that is not queued has already split the others: splitting
+    // by all its pieces but one is enough, so the largest one is skipped.
+    size_t largest = 0;
+    for (size_t i = 0; i + 1 < pieces.size(); ++i) {
+      if (pieces[i + 1] - pieces[i] > pieces[largest + 1] - pieces[largest]) {
+        largest = i;
+      }
+    }
+    const bool was_queued = is_queued[cell];
+    for (size_t i = 0; i + 1 < pieces.size(); ++i) {
+      const uint32_t start = pieces[i];
+      cell_size[start] = pieces[i + 1] - start;
+      stream.push(cell_size[start]);
+      if (start != cell) {
+        for (uint32_t j = start; j < pieces[i + 1]; ++j) {
+          cell_of[elements[j]] = start;
+        }
+      }
+      if (was_queued || i != largest) {
+        queue_cell(start);
+      }
+    }
+  }
+
+  std::vector<uint32_t> count;
+  std::vector<uint32_t> ntouched;
+  std::vector<uint32_t> touched_cells;
+  std::vector<uint32_t> pieces;
+  std::vector<bool> is_queued;
+  std::deque<uint32_t> queue;
+};
+
+} // namespace
+
+template <typename GraphT>
+Hash128 refine_colors(GraphT &g, std::vector<uint32_t> &colors) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const auto &vs = Access::vertices_of(g);
+  const uint32_t nvertices = vs.size();
+  OrderedPartition partition(nvertices);
+  InvariantStream stream;
+  stream.push(nvertices);
+
+  // The initial cells are the vertex colors, whose values are part of the
+  // invariant.
+  std::vector<uint32_t> &elements = partition.elements;
+  std::iota(elements.begin(), elements.end(), 0);
+  std::stable_sort(elements.begin(), elements.end(),
+                   [&vs](uint32_t v, uint32_t w) {
+                     return vs[v].color < vs[w].color;
+                   });
+  for (uint32_t i = 0; i < nvertices; ++i) {
+    const uint32_t v = elements[i];
+    partition.position[v] = i;
+    if (i == 0 || vs[v].color != vs[elements[i - 1]].color) {
+      partition.cell_of[v] = i;
+      stream.push(vs[v].color);
+      partition.queue_cell(i);
+    } else {
+      partition.cell_of[v] = partition.cell_of[elements[i - 1]];
+    }
+    ++partition.cell_size[partition.cell_of[v]];
+  }
+
+  std::vector<uint32_t> splitter;
+  while (partition.pop_splitter(splitter)) {
+    stream.push(partition.cell_of[splitter[0]]);
+    if constexpr (Access::is_directed) {
+      // By the number of out-neighbors in the splitter, then by the number
+      // of in-neighbors.
+      partition.split_by(
+          splitter,
+          [&vs](uint32_t u) -> const std::vector<unsigned int> & {
+            return vs[u].edges_in;
+          },
+          stream);
+      partition.split_by(
+          splitter,
+          [&vs](uint32_t u) -> const std::vector<unsigned int> & {
+            return vs[u].edges_out;
+          },
+          stream);
+    } else {
+      partition.split_by(
+          splitter,
+          [&vs](uint32_t u) -> const std::vector<unsigned int> & {
+            return vs[u].edges;
+          },
+          stream);
+    }
+  }
+
+  // Number the cells 0, 1, ... in the order of their positions.
+  colors.resize(nvertices);
+  uint32_t ncells = 0;
+  for (uint32_t i = 0; i < nvertices;) {
+    const uint32_t size = partition.cell_size[i];
+    for (uint32_t j = i; j < i + size; ++j) {
+      colors[elements[j]] = ncells;
+    }
+    ++ncells;
+    i += size;
+  }
+  return stream.finish();
+}
+
+template Hash128 refine_colors<Graph>(Graph &, std::vector<uint32_t> &);
+template Hash128 refine_colors<Digraph>(Digraph &, std::vector<uint32_t> &);
@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <cstring>
+#include <pybliss_certificate.h>
+#include <pybliss_serialization.h>
+#include <stdexcept>
+#include <string>
+
+using namespace bliss;
+
+static constexpr char MAGIC[4] = {'P', 'B', 'L', 'G'};
+static constexpr uint8_t FORMAT_VERSION = 1;
+
+template <typename GraphT> std::vector<uint8_t> serialize_graph(GraphT &g) {
+  using Access = GraphAccess<GraphT>;
+  Access::normalize(g);
+  const auto &vs = Access::vertices_of(g);
+  const auto options = Access::get_search_options(g);
+
+  std::vector<uint8_t> out(MAGIC, MAGIC + sizeof(MAGIC));
+  out.push_back(FORMAT_VERSION);
+  out.push_back(Access::is_directed ? 1 : 0);
+  out.push_back(options.flags());
+  out.push_back((uint8_t)options.splitting_heuristic);
+
+  size_t nedges = 0;
+  for (const auto &vertex : vs) {
+    nedges += Access::out_edges(vertex).size();
+  }
+  out.reserve(out.size() + 2 * vs.size() + nedges + 10);
+  append_varint(out, vs.size());
+  for (const auto &vertex : vs) {
+    append_varint(out, vertex.color);
+  }
+  for (uint32_t v = 0; v < vs.size(); ++v) {
+    const std::vector<unsigned int> &edges = Access::out_edges(vs[v]);
+    auto it = edges.begin();
+    unsigned int prev = 0;
+    if constexpr (!Access::is_directed) {
+      it = std::lower_bound(edges.begin(), edges.end(), v);
+      prev = v;
+    }
+    append_varint(out, edges.end() - it);
+    for (; it != edges.end(); ++it) {
+      append_varint(out, *it - prev);
+      prev = *it;
+    }
+  }
+  return out;
+}
+
+/**
+ * Reads an LEB128 varint of at most \p max from [\p p, \p end) and advances
+ * \p p past it.
+ */
+static uint64_t read_varint(const uint8_t *&p, const uint8_t *end,
+                            uint64_t max) {
+  uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    if (p == end) {
+      throw std::runtime_error("Error while decoding a graph: truncated "
+                               "input.");
+    }
+    const uint8_t byte = *p++;
+    value |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      if (value > max) {
+        throw std::runtime_error("Error while decoding a graph: value out of "
+                                 "range.");
+      }
+      return value;
+    }
+  }
+  throw std::runtime_error("Error while decoding a graph: malformed varint.");
+}
+
+template <typename GraphT>
+void deserialize_graph(const uint8_t *data, size_t size, ParsedGraph &parsed,
+                       typename GraphAccess<GraphT>::SearchOptions &options) {
+  using Access = GraphAccess<GraphT>;
+  const uint8_t *p = data, *end = data + size;
+  if (size < sizeof(MAGIC) + 4 || std::memcmp(p, MAGIC, sizeof(MAGIC))) {
+    throw std::runtime_error("Error while decoding a graph: not the output "
+                             "of to_bytes.");
+  }
+  p += sizeof(MAGIC);
+  const uint8_t version = *p++;
+  if (version != FORMAT_VERSION) {
+    throw std::runtime_error(
+        "Error while decoding a graph: unsupported format version " +
+        std::to_string(version) + ".");
+  }
+  const uint8_t kind = *p++;
+  if (kind != (Access::is_directed ? 1 : 0)) {
+    throw std::runtime_error(kind ? "Cannot decode a Digraph as a Graph."
+                                  : "Cannot decode a Graph as a Digraph.");
+  }
+  const uint8_t flags = *p++;
+  const uint8_t splitting_heuristic = *p++;
+  if (splitting_heuristic > GraphT::shs_flm) {
+    throw std::runtime_error("Error while decoding a graph: unknown "
+                             "splitting heuristic.");
+  }
+  using SearchOptions = typename Access::SearchOptions;
+  options.failure_recording = flags & SearchOptions::FLAG_FAILURE_RECORDING;
+  options.component_recursion =
+      flags & SearchOptions::FLAG_COMPONENT_RECURSION;
+  options.long_prune = flags & SearchOptions::FLAG_LONG_PRUNE;
+  options.splitting_heuristic =
+      (typename GraphT::SplittingHeuristic)splitting_heuristic;
+
+  // Every vertex takes at least two bytes, which bounds N by the input size
+  // before anything is allocated.
+  const uint32_t nvertices = read_varint(p, end, (end - p) / 2);
+  parsed.nvertices = nvertices;
+  parsed.colors.resize(nvertices);
+  for (uint32_t v = 0; v < nvertices; ++v) {
+    parsed.colors[v] = read_varint(p, end, UINT32_MAX);
+  }
+  parsed.edges.clear();
+  for (uint32_t v = 0; v < nvertices; ++v) {
+    const uint64_t degree = read_varint(p, end, end - p);
+    uint64_t w = Access::is_directed ? 0 : v;
+    for (uint64_t i = 0; i < degree; ++i) {
+      w += read_varint(p, end, nvertices);
+      if (w >= nvertices) {
+        throw std::runtime_error("Error while decoding a graph: vertex out "
+                                 "of range.");
+      }
+      parsed.edges.push_back(v);
+      parsed.edges.push_back(w);
+    }
+  }
+  if (p != end) {
+    throw std::runtime_error("Error while decoding a graph: trailing bytes.");
+  }
+}
+
+template std::vector<uint8_t> serialize_graph<Graph>(Graph &);
+template std::vector<uint8_t> serialize_graph<Digraph>(Digraph &);
+template void
+deserialize_graph<Graph>(const uint8_t *, size_t, ParsedGraph &,
+                         GraphAccess<Graph>::SearchOptions &);
+template void
+deserialize_graph<Digraph>(const uint8_t *, size_t, ParsedGraph &,
+                           GraphAccess<Digraph>::SearchOptions &);
@@ -2,12 +2,35 @@
 #include <bliss/graph.hh>
 #include <bliss/stats.hh>
 #include <nanobind/nanobind.h>
+#include <nanobind/stl/optional.h>
+#include <nanobind/stl/string.h>
 #include <pybliss_ext.h>
+#include <pybliss_search.h>
+#include <pybliss_search_context.h>
 
 using namespace bliss;
 
+static nb::dict profile_to_dict(const SearchProfile &profile) {
+  auto time_or_none = [](double seconds) -> nb::object {
+    return seconds < 0 ? nb::none() : nb::object(nb::float_(seconds));
+  };
+  nb::dict result;
+  result["total_time"] = profile.total_time;
+  result["report_time"] = profile.report_time;
+  result["terminate_time"] = profile.terminate_time;
+  result["progress_time"] = profile.progress_time;
+  result["first_node_time"] = time_or_none(profile.first_node_time);
+  result["first_generator_time"] = time_or_none(profile.first_generator_time);
+  result["n_nodes"] = profile.n_nodes;
+  result["n_generators"] = profile.n_generators;
+  result["n_progress_calls"] = profile.n_progress_calls;
+  result["peak_rss"] =
+      profile.peak_rss ? nb::object(nb::int_(profile.peak_rss)) : nb::none();
+  return result;
+}
+
 void bind_stats(nb::module_ &m) {
-  nb::class_<Stats>(m, "Stats",
+  nb::class_<PyStats>(m, "Stats",
                     "Records statistics returned by the search algorithms.\n\n"
                     ".. automethod:: __init__\n"
                     ".. automethod:: print_to_file\n"
@@ -20,52 +43,179 @@ void bind_stats(nb::module_ &m) {
                     ".. autoattribute:: n_canupdates\n"
                     ".. autoattribute:: n_generators\n"
                     ".. autoattribute:: max_level\n"
+                    ".. autoattribute:: completed\n"
+                    ".. autoattribute:: stop_reason\n"
+                    ".. autoattribute:: portfolio_winner\n"
+                    ".. autoattribute:: profile\n"
                     ".. automethod:: __str__")
-      .def(nb::init<>())
+      .def(
+          "__init__",
+          [](PyStats *self, bool profiling,
+             std::optional<nb::callable> progress, double progress_interval) {
+            if (!(progress_interval > 0)) {
+              throw std::runtime_error("'progress_interval' must be positive.");
+            }
+            new (self) PyStats();
+            self->profiling = profiling;
+            self->progress_interval = progress_interval;
+            if (progress) {
+              self->progress = [progress = std::move(*progress)](
+                                   const SearchProfile &profile) {
+                nb::gil_scoped_acquire acquire;
+                progress(profile_to_dict(profile));
+              };
+            }
+          },
+          "profiling"_a = false, "progress"_a = nb::none(),
+          "progress_interval"_a = 1.0,
+          "If *profiling* is *True*, the searches using these statistics "
+          "record a :attr:`profile`, at the cost of reading the clock at "
+          "every search tree node. If *progress* is given, profiling is "
+          "enabled and *progress* is called with the profile so far, as a "
+          ":class:`dict`, about every *progress_interval* seconds during a "
+          "search. It is called from the thread running the search, between "
+          "two search tree nodes, and the search may be stopped by raising "
+          "an exception from it.")
       .def("print_to_file",
-           [](Stats &self, nb::object fp_obj) {
+           [](PyStats &self, nb::object fp_obj) {
              FILE *fp = get_fp_from_writeable_pyobj(fp_obj);
              self.print(fp);
              fflush(fp);
            })
       .def_prop_ro(
           "group_size",
-          [](Stats &self) {
-            auto grp_size_str = capture_string_written_to_file(
-                [&](FILE *fp) { self.get_group_size().print(fp); });
-            return nb::int_(nb::str(grp_size_str.c_str()));
-          },
+          [](PyStats &self) { return bignum_to_int(self.group_size()); },
           "The size of the automorphism group as :class:`int`.")
       .def_prop_ro(
           "group_size_as_bignum",
-          [](Stats &self) { return self.get_group_size(); },
+          [](PyStats &self) { return self.group_size(); },
           "The size of the automorphism group as :class:`BigNum`.")
       .def_prop_ro(
           "group_size_approx",
-          [](Stats &self) { return self.get_group_size_approx(); },
+          [](PyStats &self) { return self.group_size_approx(); },
           "An approximation (due to possible overflows/rounding errors) of the"
           " size of the automorphism group")
       .def_prop_ro(
-          "n_nodes", [](Stats &self) { return self.get_nof_nodes(); },
+          "n_nodes", [](PyStats &self) { return self.n_nodes(); },
           "Number of nodes in the search tree.")
       .def_prop_ro(
-          "n_leaf_nodes", [](Stats &self) { return self.get_nof_leaf_nodes(); },
+          "n_leaf_nodes",
+          [](PyStats &self) { return self.n_leaf_nodes(); },
           "Number of leaf nodes in the search tree.")
       .def_prop_ro(
-          "n_bad_nodes", [](Stats &self) { return self.get_nof_bad_nodes(); },
+          "n_bad_nodes", [](PyStats &self) { return self.n_bad_nodes(); },
           "Number of bad nodes in the search tree.")
       .def_prop_ro(
-          "n_canupdates", [](Stats &self) { return self.get_nof_canupdates(); },
+          "n_canupdates",
+          [](PyStats &self) { return self.n_canupdates(); },
           "Number of canonical representative nodes.")
       .def_prop_ro(
-          "n_generators", [](Stats &self) { return self.get_nof_generators(); },
+          "n_generators",
+          [](PyStats &self) { return self.n_generators(); },
           "Number of generator permutations.")
       .def_prop_ro(
-          "max_level", [](Stats &self) { return self.get_max_level(); },
+          "max_level", [](PyStats &self) { return self.max_level(); },
           "The maximal depth of the search tree.")
-      .def("__str__", [](Stats &self) {
-        return nb::str(capture_string_written_to_file([&](FILE *fp) {
-                         self.print(fp);
-                       }).c_str());
+      .def_prop_ro(
+          "completed", [](PyStats &self) { return !self.stop_reason; },
+          "*False* if the search was cut short by a budget, a cancellation "
+          "or a *terminate* function, *True* otherwise.")
+      .def_prop_ro(
+          "stop_reason",
+          [](PyStats &self) -> std::optional<std::string> {
+            if (!self.stop_reason) {
+              return std::nullopt;
+            }
+            return std::string(self.stop_reason);
+          },
+          "*None* if the search completed. Otherwise, the name of what cut "
+          "it short: ``\"time_limit\"``, ``\"max_nodes\"``, "
+          "``\"max_generators\"``, ``\"cancel\"`` or ``\"terminate\"``.")
+      .def_prop_ro(
+          "portfolio_winner",
+          [](PyStats &self) { return self.portfolio_winner; },
+          "If the search raced a *portfolio* of splitting heuristics (see "
+          ":meth:`Graph.find_automorphisms`), the index in the portfolio of "
+          "the heuristic whose search finished first and that the other "
+          "statistics describe. *None* otherwise.")
+      .def_prop_ro(
+          "profile",
+          [](PyStats &self) -> std::optional<nb::dict> {
+            if (!self.profile) {
+              return std::nullopt;
+            }
+            return profile_to_dict(*self.profile);
+          },
+          "*None* unless profiling was enabled (see :meth:`__init__`). "
+          "Otherwise, a :class:`dict` describing where the last search spent "
+          "its time, measured around bliss at the points where it calls back "
+          "into pybliss (the internals of bliss, e.g. partition refinement, "
+          "are not instrumented):\n\n"
+          "- ``\"total_time\"``: the wall-clock duration of the search, in "
+          "seconds, as are all times below.\n"
+          "- ``\"report_time\"``: the time spent handling the generators "
+          "found, including the *report* callables.\n"
+          "- ``\"terminate_time\"``: the time spent in the *terminate* "
+          "callables.\n"
+          "- ``\"progress_time\"``: the time spent in the *progress* "
+          "callable.\n"
+          "- ``\"first_node_time\"``: the time until the search reached its "
+          "first search tree node, i.e. mostly the refinement of the initial "
+          "partition. *None* if it did not.\n"
+          "- ``\"first_generator_time\"``: the time until the first "
+          "generator was found. *None* if none was.\n"
+          "- ``\"n_nodes\"``: the number of search tree nodes visited.\n"
+          "- ``\"n_generators\"``: the number of generators found.\n"
+          "- ``\"n_progress_calls\"``: the number of calls to *progress*.\n"
+          "- ``\"peak_rss\"``: the peak resident set size of the process, "
+          "in bytes, at the end of the search. *None* on platforms where it "
+          "is not available.")
+      .def("__str__", [](PyStats &self) {
+        const std::string stats_str =
+            capture_string_written_to_file([&](FILE *fp) { self.print(fp); });
+        return nb::str(stats_str.data(), stats_str.size());
       });
 }
+
+void bind_cancellation_token(nb::module_ &m) {
+  nb::class_<CancellationToken>(
+      m, "CancellationToken",
+      "A flag for cancelling searches, passed as the *cancel* argument of "
+      "the search methods of :class:`Graph` and :class:`Digraph`. Searches "
+      "run without the GIL, so :meth:`cancel` may be called from any "
+      "thread while a search is running, and the search stops at its next "
+      "search tree node.\n\n"
+      ".. automethod:: __init__\n"
+      ".. automethod:: cancel\n"
+      ".. automethod:: reset\n"
+      ".. autoattribute:: is_cancelled")
+      .def(nb::init<>())
+      .def("cancel", &CancellationToken::cancel,
+           "Cancels the searches using this token.")
+      .def("reset", &CancellationToken::reset,
+           "Clears the cancellation, so that the token can be reused.")
+      .def_prop_ro("is_cancelled", &CancellationToken::is_cancelled,
+                   "Whether :meth:`cancel` was called since the last "
+                   ":meth:`reset`.");
+}
+
+void bind_search_context(nb::module_ &m) {
+  nb::class_<SearchContext>(
+      m, "SearchContext",
+      "Scratch memory that is kept across the searches it is passed to, as "
+      "the *context* argument of :meth:`Graph.canonical_certificate` and "
+      ":meth:`Graph.parallel_canonical_labeling`, instead of being "
+      "allocated and freed by every search. Reusing a context for graphs of "
+      "similar sizes avoids these allocations once it has grown to the "
+      "largest size needed. The memory that bliss allocates for its own "
+      "search tree is not part of a context. A context may be used by one "
+      "search at a time only, using it concurrently raises "
+      ":class:`RuntimeError`.\n\n"
+      ".. automethod:: __init__\n"
+      ".. autoattribute:: nbytes\n"
+      ".. automethod:: clear")
+      .def(nb::init<>())
+      .def_prop_ro("nbytes", &SearchContext::nbytes,
+                   "The number of bytes of scratch memory held.")
+      .def("clear", &SearchContext::clear, "Frees the scratch memory.");
+}
@@ -1,5 +1,8 @@
 #include "pybliss_ext.h"
+#include <bliss/bignum.hh>
 #include <bliss/utils.hh>
+#include <cstdio>
+#include <cstdlib>
 #include <memory>
 #include <nanobind/nanobind.h>
 
@@ -43,35 +46,14 @@ FILE *get_fp_from_writeable_pyobj(nb::object py_file) {
 }
 
 /**
- * Grabs the FILE* from \p py_file for reading from the file-descriptor
- * pointed by \p py_file. The returned file-pointer is seeked up to the
- * point where the python IOReader has read. We do not have any sane
- * deleters associated with the returned file pointer. Caller must manage
- * lifetime appropriately.
+ * Returns the text written by \p file_writer into the stream passed to it.
+ * The stream is backed by a growable in-memory buffer
+ * (``open_memstream``), so no file is created on disk. On platforms without
+ * ``open_memstream``, a temporary file is used instead.
  */
-FILE *get_fp_from_readable_pyobj(nb::object py_file) {
-  // Check if the object has a 'fileno' method
-  if (!nb::hasattr(py_file, "fileno")) {
-    throw std::runtime_error(
-        "Expected a file-like object with a 'fileno' method");
-  }
-
-  // Check if the object is writable
-  if (!nb::hasattr(py_file, "read")) {
-    throw std::runtime_error(
-        "File object is not readable (missing 'read' method)");
-  }
-  int fd = nb::cast<int>(py_file.attr("fileno")());
-  FILE *file = fdopen(fd, "r");
-  if (!file) {
-    throw std::runtime_error("Failed to convert file descriptor to FILE*");
-  }
-  fseek(file, nb::cast<long int>(py_file.attr("tell")()), SEEK_SET);
-  return file;
-}
-
 std::string
 capture_string_written_to_file(std::function<void(FILE *)> file_writer) {
+#if defined(_WIN32)
   // unique_ptr to ensure FILE* is properly closed
   std::unique_ptr<FILE, decltype(&fclose)> fp(tmpfile(), fclose);
   if (!fp) {
@@ -96,6 +78,46 @@ capture_string_written_to_file(std::function<void(FILE *)> file_writer) {
   fread(&output[0], 1, size, fp.get());
 
   return output;
+#else
+  char *buf = nullptr;
+  size_t size = 0;
+  FILE *fp = open_memstream(&buf, &size);
+  if (!fp) {
+    throw std::runtime_error("Failed to create in-memory stream.");
+  }
+
+  try {
+    file_writer(fp);
+  } catch (...) {
+    fclose(fp);
+    free(buf);
+    throw;
+  }
+
+  // Closing the stream finalizes *buf* and *size*.
+  fclose(fp);
+  std::string output(buf, size);
+  free(buf);
+  return output;
+#endif
+}
+
+nb::int_ bignum_to_int(const bliss::BigNum &num) {
+  const std::string digits =
+      capture_string_written_to_file([&](FILE *fp) { num.print(fp); });
+  PyObject *result = PyLong_FromString(digits.c_str(), nullptr, 10);
+  if (!result) {
+    throw nb::python_error();
+  }
+  return nb::steal<nb::int_>(result);
+}
+
+/**
+ * Returns the non-negative :class:`int` whose 64 least significant bits are
+ * \p lo and whose 64 most significant bits are \p hi.
+ */
+nb::int_ uint128_to_int(uint64_t lo, uint64_t hi) {
+  return nb::borrow<nb::int_>((nb::int_(hi) << nb::int_(64)) | nb::int_(lo));
 }
 
 void bind_utils(nb::module_ &m) {
@@ -122,7 +144,7 @@ void bind_utils(nb::module_ &m) {
           bliss::print_permutation(fp, ary.shape(0), (uint32_t *)ary.data(),
                                    offset);
         });
-        return nb::str(perm_str.c_str());
+        return nb::str(perm_str.data(), perm_str.size());
       },
       "perm"_a, "offset"_a = 0,
       "Returns a :class:`str` corresponding to the permutation *perm* in cycle "
@@ -7,23 +7,45 @@ from pybliss.utils import (
 
 from .pybliss_ext import (
     BigNum,
+    CancellationToken,
+    CanonicalIndex,
+    ComponentCache,
     Digraph,
+    EdgeColoredDigraph,
+    EdgeColoredGraph,
+    FrozenGraph,
     Graph,
+    PermutationGroup,
+    SearchContext,
     Stats,
+    are_isomorphic,
+    canonicalize_many,
     permutation_to_str,
     print_permutation_to_file,
+    refinement_invariants,
 )
 
 __all__ = [
     "BigNum",
+    "CancellationToken",
+    "CanonicalIndex",
+    "ComponentCache",
     "Digraph",
+    "EdgeColoredDigraph",
+    "EdgeColoredGraph",
+    "FrozenGraph",
     "Graph",
+    "PermutationGroup",
+    "SearchContext",
     "Stats",
     "__doc__",
+    "are_isomorphic",
+    "canonicalize_many",
     "digraph_from_numpy",
     "digraph_to_numpy",
     "graph_from_numpy",
     "graph_to_numpy",
     "permutation_to_str",
     "print_permutation_to_file",
+    "refinement_invariants",
 ]
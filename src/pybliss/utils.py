@@ -32,9 +32,11 @@ def _from_numpy_checks(
         c.shape[0] == N
     ), "'c' should have a color for every vertex in the graph."
     assert E.shape[1] == 2, "'E' must have 2 columns."
-    assert np.all(
-        np.logical_and(E >= 0, E < N)
-    ), "'E' must use 0-based labeling of vertices."
+    # Negative entries would wrap around when cast to uint32, the upper bound
+    # is checked by Graph.add_edges.
+    assert E.size == 0 or E.min() >= 0, (
+        "'E' must use 0-based labeling of vertices."
+    )
 
 
 def _graph_or_digraph_from_numpy(
@@ -42,11 +44,8 @@ def _graph_or_digraph_from_numpy(
     E: np.ndarray[tuple[int, int], np.dtype[np.integer]],
     c: np.ndarray[tuple[int], np.dtype[np.integer]],
 ) -> GT:
-    for i, j in E:
-        G.add_edge(i, j)
-
-    for i, color in enumerate(c):
-        G.change_color(i, color)
+    G.add_edges(np.ascontiguousarray(E, dtype=np.uint32))
+    G.set_colors(np.ascontiguousarray(c, dtype=np.uint32))
 
     return G
 
@@ -99,59 +98,6 @@ def digraph_from_numpy(
     return G
 
 
-def _parse_dimacs(
-    dimacs_src: str,
-) -> tuple[
-    np.ndarray[tuple[int, int], np.dtype[np.integer]],
-    np.ndarray[tuple[int], np.dtype[np.integer]],
-]:
-    # See <https://users.aalto.fi/~tjunttil/bliss/fileformat.html>
-    lines = dimacs_src.split("\n")
-    lines = [line for line in lines if line]
-    istart = 0
-    while True:
-        if not lines:
-            break
-        if not lines[istart].startswith("c"):
-            break
-        assert lines[istart].startswith("c")
-        istart += 1
-
-    problem_defn_line = lines[istart]
-    assert problem_defn_line.startswith("p edge ")
-    N, E = [
-        int(val)
-        for val in problem_defn_line[len("p edge ") :].strip().split(" ")
-    ]
-    istart += 1
-
-    edges = np.empty((E, 2), dtype=np.uint64)
-    colors = np.zeros(N, dtype=np.uint64)
-
-    i_edge = 0
-
-    for i in range(istart, len(lines)):
-        if lines[i].startswith("n"):
-            node_i, c = [int(val) for val in lines[i][2:].strip().split(" ")]
-            assert c >= 0
-            # :facepalm: dimacs uses 1-based system for labeling vertices.
-            colors[node_i - 1] = c
-        elif lines[i].startswith("e"):
-            node_i, node_j = [
-                int(val) for val in lines[i][2:].strip().split(" ")
-            ]
-            # :facepalm: dimacs uses 1-based system for labeling vertices.
-            edges[i_edge, 0] = node_i - 1
-            edges[i_edge, 1] = node_j - 1
-            i_edge += 1
-        else:
-            raise AssertionError(f"Ill-formed dimacs lines: '{lines[i]}'?")
-
-    assert i_edge == E
-
-    return edges, colors
-
-
 def graph_to_numpy(
     G: Graph,
 ) -> tuple[
@@ -168,8 +114,11 @@ def graph_to_numpy(
       *G*. Note that :math:`i, j \in \{0, 1, \ldots, N - 1\}`.
     - **c** is a 1D :class:`numpy.ndarray` of length :math:`N` such that
       ``c[i]`` corresponds to the color of the *i*-th vertex in *G*.
+
+    See :meth:`pybliss.Graph.to_csr` for exporting the adjacency in the
+    compressed sparse row format instead.
     """
-    return _parse_dimacs(G.to_dimacs())
+    return G.to_edge_array()
 
 
 def digraph_to_numpy(
@@ -188,5 +137,8 @@ def digraph_to_numpy(
       Note that :math:`i, j \in \{0, 1, \ldots, N - 1\}`.
     - **c** is a 1D :class:`numpy.ndarray` of length :math:`N` such that
       ``c[i]`` corresponds to the color of the *i*-th vertex in *G*.
+
+    See :meth:`pybliss.Graph.to_csr` for exporting the adjacency in the
+    compressed sparse row format instead.
     """
-    return _parse_dimacs(G.to_dimacs())
+    return G.to_edge_array()
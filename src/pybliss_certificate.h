@@ -0,0 +1,239 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <pybliss_graph_access.h>
+#include <string>
+#include <vector>
+
+// {{{ 128-bit hash
+
+struct Hash128 {
+  uint64_t lo, hi;
+
+  bool operator==(const Hash128 &other) const {
+    return lo == other.lo && hi == other.hi;
+  }
+};
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t fmix64(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+/**
+ * Returns the MurmurHash3 (x64, 128-bit variant) of the \p size bytes at
+ * \p data.
+ */
+inline Hash128 murmur3_128(const void *data, size_t size,
+                           uint64_t seed = 0) {
+  const uint8_t *bytes = (const uint8_t *)data;
+  const size_t nblocks = size / 16;
+  const uint64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+  uint64_t h1 = seed, h2 = seed;
+
+  for (size_t i = 0; i < nblocks; ++i) {
+    uint64_t k1, k2;
+    std::memcpy(&k1, bytes + 16 * i, 8);
+    std::memcpy(&k2, bytes + 16 * i + 8, 8);
+
+    k1 *= c1;
+    k1 = rotl64(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+    h1 = rotl64(h1, 27);
+    h1 += h2;
+    h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= c2;
+    k2 = rotl64(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+    h2 = rotl64(h2, 31);
+    h2 += h1;
+    h2 = h2 * 5 + 0x38495ab5;
+  }
+
+  const uint8_t *tail = bytes + 16 * nblocks;
+  uint64_t k1 = 0, k2 = 0;
+  switch (size & 15) {
+  case 15:
+    k2 ^= (uint64_t)tail[14] << 48;
+    [[fallthrough]];
+  case 14:
+    k2 ^= (uint64_t)tail[13] << 40;
+    [[fallthrough]];
+  case 13:
+    k2 ^= (uint64_t)tail[12] << 32;
+    [[fallthrough]];
+  case 12:
+    k2 ^= (uint64_t)tail[11] << 24;
+    [[fallthrough]];
+  case 11:
+    k2 ^= (uint64_t)tail[10] << 16;
+    [[fallthrough]];
+  case 10:
+    k2 ^= (uint64_t)tail[9] << 8;
+    [[fallthrough]];
+  case 9:
+    k2 ^= (uint64_t)tail[8];
+    k2 *= c2;
+    k2 = rotl64(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+    [[fallthrough]];
+  case 8:
+    k1 ^= (uint64_t)tail[7] << 56;
+    [[fallthrough]];
+  case 7:
+    k1 ^= (uint64_t)tail[6] << 48;
+    [[fallthrough]];
+  case 6:
+    k1 ^= (uint64_t)tail[5] << 40;
+    [[fallthrough]];
+  case 5:
+    k1 ^= (uint64_t)tail[4] << 32;
+    [[fallthrough]];
+  case 4:
+    k1 ^= (uint64_t)tail[3] << 24;
+    [[fallthrough]];
+  case 3:
+    k1 ^= (uint64_t)tail[2] << 16;
+    [[fallthrough]];
+  case 2:
+    k1 ^= (uint64_t)tail[1] << 8;
+    [[fallthrough]];
+  case 1:
+    k1 ^= (uint64_t)tail[0];
+    k1 *= c1;
+    k1 = rotl64(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+  }
+
+  h1 ^= size;
+  h2 ^= size;
+  h1 += h2;
+  h2 += h1;
+  h1 = fmix64(h1);
+  h2 = fmix64(h2);
+  h1 += h2;
+  h2 += h1;
+  return {h1, h2};
+}
+
+// }}}
+
+// {{{ certificates
+
+/**
+ * Appends \p value to \p out as an LEB128 varint. \p Bytes is a container
+ * of chars or bytes, e.g. a std::string.
+ */
+template <typename Bytes> void append_varint(Bytes &out, uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back((char)(value | 0x80));
+    value >>= 7;
+  }
+  out.push_back((char)value);
+}
+
+/**
+ * The scratch buffers of make_certificate. Keeping them across calls saves
+ * their allocations whenever the graph is not larger than the previous ones.
+ */
+struct CertificateScratch {
+  std::vector<size_t> offsets;
+  std::vector<size_t> fill;
+  std::vector<unsigned int> adjacency;
+  std::vector<uint32_t> colors;
+};
+
+/**
+ * Stores in \p out the certificate of the graph obtained by relabeling every
+ * vertex v of \p g as \p perm[v], without building that graph. Two graphs
+ * have equal certificates under their canonical labelings if and only if
+ * they are isomorphic.
+ *
+ * The certificate is a sequence of LEB128 varints: a tag (0 for a Graph,
+ * 1 for a Digraph), N, the N vertex colors, and then, for every vertex, its
+ * number of neighbors followed by the gaps between its sorted neighbors.
+ * Duplicate edges are dropped and, for a Graph, an edge {i, j} is only
+ * listed at min(i, j).
+ */
+template <typename GraphT>
+void make_certificate(const GraphT &g, const unsigned int *perm,
+                      CertificateScratch &scratch, std::string &out) {
+  using Access = GraphAccess<GraphT>;
+  const auto &vs = Access::vertices_of(g);
+  const size_t nvertices = vs.size();
+
+  // Canonical adjacency in CSR form: first count, then scatter and sort.
+  std::vector<size_t> &offsets = scratch.offsets;
+  offsets.assign(nvertices + 1, 0);
+  for (size_t v = 0; v < nvertices; ++v) {
+    for (unsigned int w : Access::out_edges(vs[v])) {
+      const unsigned int src = perm[v], dst = perm[w];
+      if (Access::is_directed || src <= dst) {
+        ++offsets[src + 1];
+      }
+    }
+  }
+  for (size_t v = 0; v < nvertices; ++v) {
+    offsets[v + 1] += offsets[v];
+  }
+  std::vector<unsigned int> &adjacency = scratch.adjacency;
+  adjacency.resize(offsets[nvertices]);
+  std::vector<size_t> &fill = scratch.fill;
+  fill.assign(offsets.begin(), offsets.end() - 1);
+  std::vector<uint32_t> &colors = scratch.colors;
+  colors.resize(nvertices);
+  for (size_t v = 0; v < nvertices; ++v) {
+    colors[perm[v]] = vs[v].color;
+    for (unsigned int w : Access::out_edges(vs[v])) {
+      const unsigned int src = perm[v], dst = perm[w];
+      if (Access::is_directed || src <= dst) {
+        adjacency[fill[src]++] = dst;
+      }
+    }
+  }
+
+  out.clear();
+  out.reserve(8 + 2 * nvertices + adjacency.size());
+  append_varint(out, Access::is_directed ? 1 : 0);
+  append_varint(out, nvertices);
+  for (uint32_t color : colors) {
+    append_varint(out, color);
+  }
+  for (size_t v = 0; v < nvertices; ++v) {
+    auto begin = adjacency.begin() + offsets[v];
+    auto end = adjacency.begin() + offsets[v + 1];
+    std::sort(begin, end);
+    end = std::unique(begin, end);
+    append_varint(out, end - begin);
+    unsigned int prev = 0;
+    for (auto it = begin; it != end; ++it) {
+      append_varint(out, *it - prev);
+      prev = *it;
+    }
+  }
+}
+
+/**
+ * Returns the certificate of \p g under \p perm, see the overload above.
+ */
+template <typename GraphT>
+std::string make_certificate(const GraphT &g, const unsigned int *perm) {
+  CertificateScratch scratch;
+  std::string out;
+  make_certificate(g, perm, scratch, out);
+  return out;
+}
+
+// }}}
@@ -0,0 +1,106 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A thread-safe LRU cache of the canonical labelings of connected
+ * components, keyed by the certificate of a component under its own
+ * labeling (see make_certificate) and the search options it was
+ * canonicalized with. A component is thus found in the cache only if it
+ * recurs with the same vertex order and adjacency, which is what repeated
+ * fragments and gadgets usually look like.
+ */
+class ComponentCache {
+public:
+  struct Entry {
+    /** The canonical labeling of the component's vertices. */
+    std::vector<uint32_t> labeling;
+    /** The certificate of the component under *labeling*. */
+    std::string certificate;
+  };
+
+  explicit ComponentCache(size_t max_size) : max_size(max_size) {}
+
+  /**
+   * Returns the entry of \p key, marking it as the most recently used, or
+   * null if there is none.
+   */
+  std::shared_ptr<const Entry> find(const std::string &key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(key);
+    if (it == index.end()) {
+      ++misses;
+      return nullptr;
+    }
+    ++hits;
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+  }
+
+  /**
+   * Stores \p entry for \p key, evicting the least recently used entries
+   * beyond the maximal size.
+   */
+  void insert(const std::string &key, std::shared_ptr<const Entry> entry) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (max_size == 0 || index.count(key)) {
+      return;
+    }
+    entries.emplace_front(key, std::move(entry));
+    index.emplace(key, entries.begin());
+    while (entries.size() > max_size) {
+      index.erase(entries.back().first);
+      entries.pop_back();
+    }
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    index.clear();
+    entries.clear();
+    hits = misses = 0;
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+  }
+  size_t get_max_size() const { return max_size; }
+  uint64_t get_hits() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+  }
+  uint64_t get_misses() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+  }
+
+private:
+  using Item = std::pair<std::string, std::shared_ptr<const Entry>>;
+
+  const size_t max_size;
+  std::mutex mutex;
+  std::list<Item> entries;
+  std::unordered_map<std::string, std::list<Item>::iterator> index;
+  uint64_t hits = 0, misses = 0;
+};
+
+/**
+ * Returns a canonical labeling of \p g computed component by component: the
+ * (weakly) connected components are canonicalized separately by bliss,
+ * through \p cache if not null, and laid out one after the other in the
+ * order of their canonical certificates. Isomorphic graphs get the same
+ * canonical form, which in general differs from bliss's canonical form of
+ * the whole graph. The components are searched with the options of \p g.
+ *
+ * Normalizes \p g (see GraphAccess::normalize). May be called without the
+ * GIL.
+ */
+template <typename GraphT>
+std::vector<uint32_t> canonical_labeling_by_components(GraphT &g,
+                                                       ComponentCache *cache);
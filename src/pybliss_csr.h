@@ -0,0 +1,175 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <nanobind/nanobind.h>
+#include <nanobind/ndarray.h>
+#include <memory>
+#include <optional>
+#include <pybliss_graph_access.h>
+#include <stdexcept>
+#include <vector>
+
+namespace nb = nanobind;
+
+using IndexArray = nb::ndarray<nb::ro, nb::ndim<1>, nb::c_contig>;
+using CsrColorArray = nb::ndarray<const uint32_t, nb::ndim<1>, nb::c_contig>;
+
+/**
+ * Borrowed arrays describing a graph in compressed sparse row (CSR) form:
+ * the out-neighbors of vertex v are indices[indptr[v]:indptr[v + 1]]. This
+ * is the layout of :class:`scipy.sparse.csr_array`. *indptr* holds 32- or
+ * 64-bit offsets. *colors* is null if all vertices have color 0.
+ */
+struct CsrGraph {
+  size_t nvertices = 0;
+  const void *indptr = nullptr;
+  bool is_indptr_wide = false;
+  const uint32_t *indices = nullptr;
+  size_t nentries = 0;
+  const uint32_t *colors = nullptr;
+
+  uint64_t offset(size_t i) const {
+    return is_indptr_wide ? ((const uint64_t *)indptr)[i]
+                          : ((const uint32_t *)indptr)[i];
+  }
+  const uint32_t *row_begin(size_t v) const { return indices + offset(v); }
+  const uint32_t *row_end(size_t v) const { return indices + offset(v + 1); }
+  uint32_t color(size_t v) const { return colors ? colors[v] : 0; }
+};
+
+/**
+ * Returns a CsrGraph viewing the given arrays. *indptr* may be of any 32- or
+ * 64-bit integer dtype, *indices* of dtype ``int32`` or ``uint32``, negative
+ * entries being rejected by validate_csr. Only checks the dtypes and shapes
+ * of the arrays, not their contents.
+ */
+inline CsrGraph csr_from_arrays(const IndexArray &indptr,
+                                const IndexArray &indices,
+                                const std::optional<CsrColorArray> &colors) {
+  auto is_integer = [](const nb::dlpack::dtype &dtype, int bits) {
+    return dtype.lanes == 1 && dtype.bits == bits &&
+           (dtype.code == (uint8_t)nb::dlpack::dtype_code::Int ||
+            dtype.code == (uint8_t)nb::dlpack::dtype_code::UInt);
+  };
+  CsrGraph csr;
+  if (indptr.shape(0) == 0) {
+    throw std::runtime_error("'indptr' must have N+1 entries.");
+  }
+  if (is_integer(indptr.dtype(), 64)) {
+    csr.is_indptr_wide = true;
+  } else if (!is_integer(indptr.dtype(), 32)) {
+    throw std::runtime_error("'indptr' must be an array of 32- or 64-bit "
+                             "integers.");
+  }
+  if (!is_integer(indices.dtype(), 32)) {
+    throw std::runtime_error("'indices' must be an array of 32-bit "
+                             "integers.");
+  }
+  csr.nvertices = indptr.shape(0) - 1;
+  csr.indptr = indptr.data();
+  csr.indices = (const uint32_t *)indices.data();
+  csr.nentries = indices.shape(0);
+  if (colors) {
+    if (colors->shape(0) != csr.nvertices) {
+      throw std::runtime_error(
+          "Color array must have an entry for every vertex of the graph.");
+    }
+    csr.colors = (const uint32_t *)colors->data();
+  }
+  return csr;
+}
+
+/**
+ * Checks that \p csr describes a graph: the offsets start at 0, never
+ * decrease and end at the number of entries, and the entries are vertices.
+ * If \p require_sorted, the rows must also be sorted. Throws
+ * std::runtime_error otherwise. May be called without the GIL.
+ */
+inline void validate_csr(const CsrGraph &csr, bool require_sorted) {
+  if (csr.offset(0) != 0 || csr.offset(csr.nvertices) != csr.nentries) {
+    throw std::runtime_error("'indptr' must start at 0 and end at the "
+                             "length of 'indices'.");
+  }
+  // All the offsets are checked before any row is read, so that a row
+  // never extends past the end of the indices.
+  for (size_t v = 0; v < csr.nvertices; ++v) {
+    if (csr.offset(v) > csr.offset(v + 1)) {
+      throw std::runtime_error("'indptr' must be non-decreasing.");
+    }
+  }
+  for (size_t v = 0; v < csr.nvertices; ++v) {
+    for (const uint32_t *w = csr.row_begin(v); w != csr.row_end(v); ++w) {
+      if (*w >= csr.nvertices) {
+        throw std::runtime_error(
+            "'indices' must use 0-based labeling of the vertices.");
+      }
+      if (require_sorted && w != csr.row_begin(v) && w[-1] > *w) {
+        throw std::runtime_error("The rows of 'indices' must be sorted.");
+      }
+    }
+  }
+}
+
+/**
+ * Returns true if, for every edge from v to w in \p csr, there is an edge
+ * from w to v. The rows of \p csr must be sorted.
+ */
+inline bool csr_is_symmetric(const CsrGraph &csr) {
+  for (uint32_t v = 0; v < csr.nvertices; ++v) {
+    for (const uint32_t *w = csr.row_begin(v); w != csr.row_end(v); ++w) {
+      if (!std::binary_search(csr.row_begin(*w), csr.row_end(*w), v)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Returns a new graph with the vertices, colors and edges of \p csr, which
+ * must have been validated. For a Graph, \p csr is the symmetric adjacency
+ * structure, listing every edge {v, w} in the rows of both v and w (a
+ * self-loop once), and std::runtime_error is thrown if it is not symmetric.
+ * For a Digraph, the rows list the out-neighbors.
+ *
+ * Every adjacency list is allocated once, at its final size. May be called
+ * without the GIL.
+ */
+template <typename GraphT>
+std::unique_ptr<GraphT> graph_from_csr(const CsrGraph &csr) {
+  using Access = GraphAccess<GraphT>;
+  auto g = std::make_unique<GraphT>(csr.nvertices);
+  auto &vs = Access::vertices_of(*g);
+  for (size_t v = 0; v < csr.nvertices; ++v) {
+    vs[v].color = csr.color(v);
+  }
+  if constexpr (Access::is_directed) {
+    std::vector<uint32_t> in_degree(csr.nvertices, 0);
+    for (size_t i = 0; i < csr.nentries; ++i) {
+      ++in_degree[csr.indices[i]];
+    }
+    for (size_t v = 0; v < csr.nvertices; ++v) {
+      vs[v].edges_out.assign(csr.row_begin(v), csr.row_end(v));
+      vs[v].edges_in.reserve(in_degree[v]);
+    }
+    for (uint32_t v = 0; v < csr.nvertices; ++v) {
+      for (const uint32_t *w = csr.row_begin(v); w != csr.row_end(v); ++w) {
+        vs[*w].edges_in.push_back(v);
+      }
+    }
+  } else {
+    for (size_t v = 0; v < csr.nvertices; ++v) {
+      vs[v].edges.assign(csr.row_begin(v), csr.row_end(v));
+    }
+    Access::normalize(*g);
+    for (uint32_t v = 0; v < csr.nvertices; ++v) {
+      for (uint32_t w : vs[v].edges) {
+        if (!std::binary_search(vs[w].edges.begin(), vs[w].edges.end(), v)) {
+          throw std::runtime_error(
+              "The adjacency structure of a Graph must be symmetric.");
+        }
+      }
+    }
+  }
+  return g;
+}
@@ -6,7 +6,16 @@ NB_MODULE(pybliss_ext, m) {
 
   bind_bignum(m);
   bind_stats(m);
+  bind_cancellation_token(m);
+  bind_search_context(m);
+  bind_component_cache(m);
   bind_graph(m);
   bind_digraph(m);
   bind_utils(m);
+  bind_batch(m);
+  bind_canonical_index(m);
+  bind_group(m);
+  bind_frozen_graph(m);
+  bind_isomorphism(m);
+  bind_edge_colored_graph(m);
 }
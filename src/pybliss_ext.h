@@ -1,7 +1,10 @@
 #pragma once
+#include <bliss/bignum.hh>
 #include <functional>
+#include <initializer_list>
 #include <nanobind/nanobind.h>
 #include <nanobind/ndarray.h>
+#include <vector>
 
 namespace nb = nanobind;
 
@@ -12,15 +15,50 @@ using namespace nb::literals;
 void perform_sanity_checks_on_perm_array(
     const nb::ndarray<uint32_t, nb::ndim<1>> &ary, size_t reqd_size);
 FILE *get_fp_from_writeable_pyobj(nb::object file_obj);
-FILE *get_fp_from_readable_pyobj(nb::object file_obj);
 std::string
 capture_string_written_to_file(std::function<void(FILE *)> file_writer);
+nb::int_ bignum_to_int(const bliss::BigNum &num);
+nb::int_ uint128_to_int(uint64_t lo, uint64_t hi);
+
+/**
+ * Returns a numpy array of shape \p shape viewing \p data. The array takes
+ * ownership of \p data, which must have been allocated with ``new T[]``.
+ */
+template <typename T>
+nb::ndarray<nb::numpy, T>
+make_owned_ndarray(T *data, std::initializer_list<size_t> shape) {
+  nb::capsule owner(data, [](void *p) noexcept { delete[] (T *)p; });
+  return nb::ndarray<nb::numpy, T>(data, shape, owner);
+}
+
+/**
+ * Returns a numpy array of shape \p shape viewing the elements of \p data,
+ * which the array takes over without copying them.
+ */
+template <typename T>
+nb::ndarray<nb::numpy, T>
+make_owned_ndarray(std::vector<T> &&data, std::initializer_list<size_t> shape) {
+  auto *owned = new std::vector<T>(std::move(data));
+  nb::capsule owner(owned, [](void *p) noexcept {
+    delete (std::vector<T> *)p;
+  });
+  return nb::ndarray<nb::numpy, T>(owned->data(), shape, owner);
+}
 
 // }}}
 
 // Bind bliss classes
 void bind_bignum(nb::module_ &m);
 void bind_stats(nb::module_ &m);
+void bind_cancellation_token(nb::module_ &m);
+void bind_search_context(nb::module_ &m);
 void bind_graph(nb::module_ &m);
 void bind_digraph(nb::module_ &m);
 void bind_utils(nb::module_ &m);
+void bind_batch(nb::module_ &m);
+void bind_canonical_index(nb::module_ &m);
+void bind_group(nb::module_ &m);
+void bind_frozen_graph(nb::module_ &m);
+void bind_isomorphism(nb::module_ &m);
+void bind_component_cache(nb::module_ &m);
+void bind_edge_colored_graph(nb::module_ &m);
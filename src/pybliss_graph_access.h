@@ -0,0 +1,156 @@
+#pragma once
+#include <bliss/digraph.hh>
+#include <bliss/graph.hh>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Grants the bindings access to the protected members of bliss's
+ * :class:`Graph` and :class:`Digraph`, so that bulk operations can work on the
+ * adjacency lists directly instead of going through one member function call
+ * per vertex/edge.
+ *
+ * This class is never instantiated. Its only purpose is to name the protected
+ * members from a derived class, which is what makes forming pointers to them
+ * legal.
+ */
+template <typename GraphT> struct GraphAccess : GraphT {
+  using Vertex = typename GraphT::Vertex;
+  static constexpr bool is_directed =
+      std::is_same<GraphT, bliss::Digraph>::value;
+
+  static std::vector<Vertex> &vertices_of(GraphT &g) {
+    return g.*(&GraphAccess::vertices);
+  }
+
+  static const std::vector<Vertex> &vertices_of(const GraphT &g) {
+    return g.*(&GraphAccess::vertices);
+  }
+
+  /**
+   * Returns the out-neighbors of \p v for a Digraph, and all the neighbors of
+   * \p v for a Graph.
+   */
+  static const std::vector<unsigned int> &out_edges(const Vertex &v) {
+    if constexpr (is_directed) {
+      return v.edges_out;
+    } else {
+      return v.edges;
+    }
+  }
+
+  /**
+   * Adds the \p nedges edges stored as consecutive vertex pairs in \p edges
+   * to \p g. Every adjacency list is grown at most once, and the edges are
+   * then filled in a single pass. The vertices must be valid vertices of
+   * \p g.
+   */
+  static void add_edges(GraphT &g, const uint32_t *edges, size_t nedges) {
+    std::vector<Vertex> &vs = vertices_of(g);
+    const size_t nvertices = vs.size();
+    if constexpr (is_directed) {
+      std::vector<uint32_t> out_degree(nvertices, 0), in_degree(nvertices, 0);
+      for (size_t i = 0; i < nedges; ++i) {
+        ++out_degree[edges[2 * i]];
+        ++in_degree[edges[2 * i + 1]];
+      }
+      for (size_t v = 0; v < nvertices; ++v) {
+        vs[v].edges_out.reserve(vs[v].edges_out.size() + out_degree[v]);
+        vs[v].edges_in.reserve(vs[v].edges_in.size() + in_degree[v]);
+      }
+      for (size_t i = 0; i < nedges; ++i) {
+        vs[edges[2 * i]].edges_out.push_back(edges[2 * i + 1]);
+        vs[edges[2 * i + 1]].edges_in.push_back(edges[2 * i]);
+      }
+    } else {
+      std::vector<uint32_t> degree(nvertices, 0);
+      for (size_t i = 0; i < 2 * nedges; ++i) {
+        ++degree[edges[i]];
+      }
+      for (size_t v = 0; v < nvertices; ++v) {
+        vs[v].edges.reserve(vs[v].edges.size() + degree[v]);
+      }
+      for (size_t i = 0; i < nedges; ++i) {
+        vs[edges[2 * i]].edges.push_back(edges[2 * i + 1]);
+        vs[edges[2 * i + 1]].edges.push_back(edges[2 * i]);
+      }
+    }
+  }
+
+  /**
+   * Sets the color of vertex i of \p g to \p colors[i] for every vertex.
+   */
+  static void set_colors(GraphT &g, const uint32_t *colors) {
+    std::vector<Vertex> &vs = vertices_of(g);
+    for (size_t v = 0; v < vs.size(); ++v) {
+      vs[v].color = colors[v];
+    }
+  }
+
+  /**
+   * The options that steer the searches of a graph, besides the arguments
+   * of the search itself.
+   */
+  struct SearchOptions {
+    typename GraphT::SplittingHeuristic splitting_heuristic;
+    bool failure_recording;
+    bool component_recursion;
+    bool long_prune;
+
+    enum : uint8_t {
+      FLAG_FAILURE_RECORDING = 1,
+      FLAG_COMPONENT_RECURSION = 2,
+      FLAG_LONG_PRUNE = 4,
+    };
+
+    /**
+     * Returns the boolean options as a byte of FLAG_* bits.
+     */
+    uint8_t flags() const {
+      return (failure_recording ? FLAG_FAILURE_RECORDING : 0) |
+             (component_recursion ? FLAG_COMPONENT_RECURSION : 0) |
+             (long_prune ? FLAG_LONG_PRUNE : 0);
+    }
+
+    bool operator==(const SearchOptions &other) const {
+      return splitting_heuristic == other.splitting_heuristic &&
+             failure_recording == other.failure_recording &&
+             component_recursion == other.component_recursion &&
+             long_prune == other.long_prune;
+    }
+    bool operator!=(const SearchOptions &other) const {
+      return !(*this == other);
+    }
+  };
+
+  static SearchOptions get_search_options(const GraphT &g) {
+    return {g.*(&GraphAccess::sh), g.*(&GraphAccess::opt_use_failure_recording),
+            g.*(&GraphAccess::opt_use_comprec),
+            g.*(&GraphAccess::opt_use_long_prune)};
+  }
+
+  static void set_search_options(GraphT &g, const SearchOptions &options) {
+    g.*(&GraphAccess::sh) = options.splitting_heuristic;
+    g.*(&GraphAccess::opt_use_failure_recording) = options.failure_recording;
+    g.*(&GraphAccess::opt_use_comprec) = options.component_recursion;
+    g.*(&GraphAccess::opt_use_long_prune) = options.long_prune;
+  }
+
+  /**
+   * Makes \p to search like \p from: copies the splitting heuristic and the
+   * failure recording, component recursion and long prune options.
+   */
+  static void copy_search_options(const GraphT &from, GraphT &to) {
+    set_search_options(to, get_search_options(from));
+  }
+
+  /**
+   * Removes the duplicate edges of \p g and sorts its adjacency lists, as
+   * bliss does before writing or comparing graphs.
+   */
+  static void normalize(GraphT &g) {
+    (g.*(&GraphAccess::remove_duplicate_edges))();
+    (g.*(&GraphAccess::sort_edges))();
+  }
+};
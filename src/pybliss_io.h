@@ -0,0 +1,159 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <nanobind/nanobind.h>
+#include <string>
+#include <vector>
+
+namespace nb = nanobind;
+
+// {{{ byte sources
+
+/**
+ * A read-only sequence of bytes delivered in chunks. Sources backed by
+ * memory (memory-mapped files, :class:`bytes`) deliver everything in a single
+ * chunk, Python streams deliver one chunk per ``read`` call.
+ *
+ * next_chunk may be called without holding the GIL.
+ */
+class ByteSource {
+public:
+  virtual ~ByteSource() = default;
+
+  /**
+   * Stores the next chunk in [\p data, \p data + \p size). The chunk stays
+   * valid until the next call. Returns false once the source is exhausted.
+   */
+  virtual bool next_chunk(const char *&data, size_t &size) = 0;
+};
+
+/**
+ * Returns a ByteSource reading from \p obj, which can be:
+ *
+ * - a :class:`str` or :class:`os.PathLike`, interpreted as a path to a file,
+ * - a :class:`bytes`-like object holding the contents,
+ * - a binary file object opened on a regular file, memory-mapped from its
+ *   current position and then moved to its end,
+ * - any other object with a ``read`` method (e.g. a text file,
+ *   :class:`io.BytesIO`, :class:`gzip.GzipFile`), read in chunks.
+ *
+ * Paths to regular files are memory-mapped where the platform allows it.
+ * Must be called with the GIL held.
+ */
+std::unique_ptr<ByteSource> open_byte_source(nb::object obj);
+
+/**
+ * Splits the bytes of a ByteSource into lines. Lines that lie within a chunk
+ * are returned in place, only lines straddling two chunks are copied.
+ */
+class LineReader {
+public:
+  explicit LineReader(std::unique_ptr<ByteSource> source)
+      : source(std::move(source)) {}
+
+  /**
+   * Stores the next line, without its line terminator, in [\p begin,
+   * \p end). The line stays valid until the next call. Returns false at the
+   * end of the input.
+   */
+  bool next_line(const char *&begin, const char *&end);
+
+  /**
+   * Makes the next call to next_line return the current line again.
+   */
+  void put_back() { is_put_back = true; }
+
+  /**
+   * Returns the 1-based number of the current line.
+   */
+  size_t line_number() const { return lineno; }
+
+private:
+  std::unique_ptr<ByteSource> source;
+  const char *cur = nullptr, *chunk_end = nullptr;
+  const char *line_begin = nullptr, *line_end = nullptr;
+  std::string carry;
+  bool is_carry_returned = false;
+  bool is_put_back = false;
+  bool is_exhausted = false;
+  size_t lineno = 0;
+};
+
+// }}}
+
+// {{{ parsers
+
+/**
+ * A vertex-colored graph as read from a file, before being converted to a
+ * Graph or a Digraph. *edges* stores the endpoints of the i-th edge at
+ * indices 2i and 2i+1, using 0-based vertex labels.
+ */
+struct ParsedGraph {
+  unsigned int nvertices = 0;
+  std::vector<uint32_t> colors;
+  std::vector<uint32_t> edges;
+};
+
+/**
+ * Reads the next graph in the DIMACS format from \p reader into \p graph.
+ * Consecutive graphs in the same input are separated by their problem lines.
+ * Returns false if the input holds no more graphs. Throws
+ * std::runtime_error on malformed input.
+ */
+bool read_dimacs_graph(LineReader &reader, ParsedGraph &graph);
+
+/**
+ * Parses the graph encoded in graph6 or sparse6 (detected from the leading
+ * ``:``) in [\p begin, \p end) into \p graph. An optional
+ * ``>>graph6<<``/``>>sparse6<<`` header is skipped. Throws
+ * std::runtime_error on malformed input.
+ */
+void parse_graph6(const char *begin, const char *end, ParsedGraph &graph);
+
+/**
+ * Parses the directed graph encoded in digraph6 in [\p begin, \p end) into
+ * \p graph. An optional ``>>digraph6<<`` header is skipped. Throws
+ * std::runtime_error on malformed input.
+ */
+void parse_digraph6(const char *begin, const char *end, ParsedGraph &graph);
+
+/**
+ * Reads the graph on the next non-empty line of \p reader, as parse_graph6
+ * does. Returns false at the end of the input.
+ */
+bool read_graph6_graph(LineReader &reader, ParsedGraph &graph);
+
+/**
+ * Reads the graph on the next non-empty line of \p reader, as parse_digraph6
+ * does. Returns false at the end of the input.
+ */
+bool read_digraph6_graph(LineReader &reader, ParsedGraph &graph);
+
+// }}}
+
+// {{{ writers
+
+/**
+ * Returns the graph6 encoding, without a trailing newline, of the undirected
+ * graph with \p nvertices vertices and edges \p edges (stored as in
+ * ParsedGraph). Throws std::runtime_error for self-loops, which graph6
+ * cannot represent.
+ */
+std::string encode_graph6(uint32_t nvertices,
+                          const std::vector<uint32_t> &edges);
+
+/**
+ * Returns the sparse6 encoding, without a trailing newline, of the undirected
+ * graph with \p nvertices vertices and edges \p edges.
+ */
+std::string encode_sparse6(uint32_t nvertices,
+                           const std::vector<uint32_t> &edges);
+
+/**
+ * Returns the digraph6 encoding, without a trailing newline, of the directed
+ * graph with \p nvertices vertices and edges \p edges.
+ */
+std::string encode_digraph6(uint32_t nvertices,
+                            const std::vector<uint32_t> &edges);
+
+// }}}
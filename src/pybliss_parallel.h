@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Returns the number of native worker threads to use when the caller asked
+ * for \p n_threads threads. A request of 0 threads stands for one thread per
+ * hardware thread.
+ */
+inline unsigned int resolve_n_threads(unsigned int n_threads) {
+  if (n_threads == 0) {
+    n_threads = std::thread::hardware_concurrency();
+  }
+  return std::max(1u, n_threads);
+}
+
+/**
+ * A fixed set of [lo, hi) chunk ranges, one per worker, supporting
+ * lock-free work-stealing. The owner of a range pops chunks from its front
+ * while thieves take chunks from its back. Both ends of a range are packed
+ * in a single 64-bit word so that every pop is a single CAS.
+ */
+class WorkStealingRanges {
+public:
+  WorkStealingRanges(uint32_t n_chunks, unsigned int n_workers)
+      : ranges(n_workers) {
+    for (unsigned int w = 0; w < n_workers; ++w) {
+      const uint32_t lo = (uint64_t)n_chunks * w / n_workers;
+      const uint32_t hi = (uint64_t)n_chunks * (w + 1) / n_workers;
+      ranges[w].bounds.store(pack(lo, hi), std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Stores the next chunk for \p worker in \p chunk. Chunks are taken from
+   * the worker's own range first, and stolen from the other workers once it
+   * is drained. Returns false when no chunks are left anywhere.
+   */
+  bool next(unsigned int worker, uint32_t &chunk) {
+    if (pop_front(ranges[worker], chunk)) {
+      return true;
+    }
+    const unsigned int n_workers = ranges.size();
+    for (unsigned int i = 1; i < n_workers; ++i) {
+      if (steal_back(ranges[(worker + i) % n_workers], chunk)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  struct alignas(64) Range {
+    std::atomic<uint64_t> bounds;
+  };
+  std::vector<Range> ranges;
+
+  static uint64_t pack(uint32_t lo, uint32_t hi) {
+    return ((uint64_t)lo << 32) | hi;
+  }
+
+  static bool pop_front(Range &r, uint32_t &chunk) {
+    uint64_t b = r.bounds.load(std::memory_order_relaxed);
+    while (true) {
+      const uint32_t lo = b >> 32, hi = (uint32_t)b;
+      if (lo >= hi) {
+        return false;
+      }
+      if (r.bounds.compare_exchange_weak(b, pack(lo + 1, hi),
+                                         std::memory_order_acq_rel)) {
+        chunk = lo;
+        return true;
+      }
+    }
+  }
+
+  static bool steal_back(Range &r, uint32_t &chunk) {
+    uint64_t b = r.bounds.load(std::memory_order_relaxed);
+    while (true) {
+      const uint32_t lo = b >> 32, hi = (uint32_t)b;
+      if (lo >= hi) {
+        return false;
+      }
+      if (r.bounds.compare_exchange_weak(b, pack(lo, hi - 1),
+                                         std::memory_order_acq_rel)) {
+        chunk = hi - 1;
+        return true;
+      }
+    }
+  }
+};
+
+/**
+ * Calls ``body(i, worker)`` for every \p i in [0, \p n) on a pool of
+ * \p n_threads native threads (see resolve_n_threads), with ``worker`` in
+ * [0, n_workers). The index space is cut into chunks that are balanced
+ * between the workers by work-stealing. The first exception thrown by
+ * \p body stops the remaining work and is rethrown on the calling thread.
+ *
+ * \p body runs on threads that do not hold the GIL and thus must not touch
+ * Python objects.
+ */
+template <typename F>
+void parallel_for(size_t n, unsigned int n_threads, F &&body) {
+  const unsigned int n_workers =
+      (unsigned int)std::min<size_t>(resolve_n_threads(n_threads), n);
+  if (n_workers <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      body(i, 0u);
+    }
+    return;
+  }
+
+  // ~64 chunks per worker gives enough slack for stealing to balance
+  // irregular work, while keeping the per-chunk overhead negligible.
+  const size_t grain = std::max<size_t>(1, n / (64 * (size_t)n_workers));
+  const uint32_t n_chunks = (uint32_t)((n + grain - 1) / grain);
+  WorkStealingRanges ranges(n_chunks, n_workers);
+
+  std::atomic<bool> failed(false);
+  std::exception_ptr error = nullptr;
+  std::mutex error_mutex;
+
+  auto worker_loop = [&](unsigned int worker) {
+    uint32_t chunk;
+    while (!failed.load(std::memory_order_relaxed) &&
+           ranges.next(worker, chunk)) {
+      const size_t begin = (size_t)chunk * grain;
+      const size_t end = std::min(n, begin + grain);
+      try {
+        for (size_t i = begin; i < end; ++i) {
+          body(i, worker);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed.store(true, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(n_workers - 1);
+  for (unsigned int w = 1; w < n_workers; ++w) {
+    threads.emplace_back(worker_loop, w);
+  }
+  worker_loop(0);
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+/**
+ * Returns the indices of the first occurrence of every distinct object in
+ * \p objects and stores in \p first_occurrence[i] the index of the first
+ * occurrence of \p objects[i].
+ *
+ * Graph objects can only be searched by one thread at a time. Hence, batch
+ * operations search repeated entries once and copy their results over.
+ */
+template <typename T>
+std::vector<size_t>
+find_first_occurrences(const std::vector<T *> &objects,
+                       std::vector<size_t> &first_occurrence) {
+  std::vector<size_t> unique_ids;
+  std::unordered_map<const T *, size_t> seen;
+  seen.reserve(objects.size());
+  first_occurrence.resize(objects.size());
+  for (size_t i = 0; i < objects.size(); ++i) {
+    auto [it, inserted] = seen.emplace(objects[i], i);
+    first_occurrence[i] = it->second;
+    if (inserted) {
+      unique_ids.push_back(i);
+    }
+  }
+  return unique_ids;
+}
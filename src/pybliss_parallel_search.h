@@ -0,0 +1,68 @@
+#pragma once
+#include <pybliss_search.h>
+#include <pybliss_search_context.h>
+#include <vector>
+
+/**
+ * Searches the automorphism group, and the canonical labeling if
+ * \p canonical, of \p g on \p n_threads native threads (see
+ * resolve_n_threads). The canonical labeling is stored in
+ * \p context.labeling, which is left empty if \p canonical is false or if
+ * the search stopped before any branch completed. The workers build their
+ * certificates in \p context.branch_scratch, so that a reused context saves
+ * these allocations.
+ *
+ * The search branches on the vertices of a target cell: the cell of the
+ * equitable partition computed by color refinement (see refine_colors) that
+ * the splitting heuristic of \p g picks, as bliss picks one among the cells
+ * of its own partition. If refinement distinguishes all the vertices, \p g
+ * is searched sequentially instead, as bliss then finds the labeling at the
+ * root of its search tree. Every branch is a bliss search on a copy of \p g
+ * in which the branching vertex has a color of its own. The branches are
+ * handed out to the threads through work stealing (see parallel_for).
+ * Branches whose vertex lies in the orbit of a previous branch's vertex
+ * under the automorphisms found so far are pruned. The results of the
+ * branches are committed in the order of their vertices, and a branch that
+ * the sequential order would have pruned is discarded at commit time, so
+ * that the outcome does not depend on the number of threads or on their
+ * timing.
+ *
+ * The canonical labeling is the one of the branch with the smallest
+ * canonical certificate. Unless \p g is searched sequentially, it is not the
+ * labeling of bliss's own search, which bliss picks among the leaves of a
+ * single search tree and cannot be resumed from a given first level
+ * branch: it is a canonical labeling of its own, which must only be
+ * compared with labelings computed by this function.
+ *
+ * The generators found in every searched branch, and the automorphisms
+ * mapping branches with equal certificates onto each other, are passed to
+ * the report hook of \p monitor in a deterministic order. Together they
+ * generate the automorphism group. The hooks of \p monitor bound all the
+ * branches together. The combined statistics are stored in \p stats. \p g
+ * must not be modified or searched by other threads during the search. Must
+ * be called without the GIL.
+ */
+template <typename GraphT>
+void parallel_search(GraphT &g, bool canonical, unsigned int n_threads,
+                     SearchMonitor &monitor, PyStats &stats,
+                     SearchContext &context);
+
+/**
+ * Searches the automorphism group of \p g once per splitting heuristic in
+ * \p heuristics, each on a copy of \p g and on a native thread of its own,
+ * and stops the other searches as soon as one completes. The automorphism
+ * group does not depend on the heuristic, so the first search to finish
+ * decides the outcome. Its statistics are stored in \p stats, with its index
+ * in \p heuristics as stats.portfolio_winner.
+ *
+ * The generators of the winning search are passed to the report hook of
+ * \p monitor once the race is over, from the calling thread. The budgets of
+ * \p monitor apply to all the searches of the race together, except for
+ * max_generators, which each search checks against its own generators.
+ * \p heuristics must not be empty. Must be called without the GIL.
+ */
+template <typename GraphT>
+void portfolio_search(
+    GraphT &g,
+    const std::vector<typename GraphT::SplittingHeuristic> &heuristics,
+    SearchMonitor &monitor, PyStats &stats);
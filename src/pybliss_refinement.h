@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdint>
+#include <pybliss_certificate.h>
+#include <vector>
+
+/**
+ * Runs color refinement (the 1-dimensional Weisfeiler-Leman algorithm) on
+ * \p g from the partition of its vertices by color, until the coloring is
+ * stable, and stores in \p colors the stable color of every vertex.
+ *
+ * The refinement works on an ordered partition with a queue of splitter
+ * cells: a splitter splits the cells of the neighbors of its vertices (of
+ * the out- and of the in-neighbors for a Digraph) by their number of
+ * neighbors in it, and only the new cells are queued, all but the largest
+ * one if the split cell was not queued. A vertex is thus in O(log N)
+ * splitters, and the work is about O(M log N) for M edges, whereas
+ * recomputing the colors of all the vertices round after round could take
+ * a number of rounds linear in N, e.g. on a path. The pieces of a cell are
+ * ordered by the numbers they were split by and the colors are numbered in
+ * the order of the cells, so that isomorphic graphs get colorings that
+ * correspond under every isomorphism.
+ *
+ * The returned hash covers the initial colors and every split with the
+ * sizes of the pieces: graphs with different hashes are not isomorphic,
+ * while graphs that color refinement does not distinguish (e.g. regular
+ * graphs of the same degree and order) get equal hashes.
+ *
+ * Normalizes \p g (see GraphAccess::normalize). May be called without the
+ * GIL.
+ */
+template <typename GraphT>
+Hash128 refine_colors(GraphT &g, std::vector<uint32_t> &colors);
@@ -0,0 +1,461 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bliss/bignum.hh>
+#include <bliss/stats.hh>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <pybliss_ext.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+/**
+ * A flag through which a search running without the GIL can be cancelled
+ * from another thread.
+ */
+class CancellationToken {
+public:
+  void cancel() { cancelled.store(true, std::memory_order_relaxed); }
+  void reset() { cancelled.store(false, std::memory_order_relaxed); }
+  bool is_cancelled() const {
+    return cancelled.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<bool> cancelled{false};
+};
+
+/**
+ * Returns the peak resident set size of the process in bytes, or 0 where it
+ * cannot be queried.
+ */
+inline uint64_t peak_rss_bytes() {
+#if defined(__unix__) || defined(__APPLE__)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage)) {
+    return 0;
+  }
+#if defined(__APPLE__)
+  return (uint64_t)usage.ru_maxrss;
+#else
+  return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+/**
+ * What a SearchMonitor measured around a bliss search when profiling. The
+ * times are wall-clock seconds since the search started. bliss's internals
+ * (refinement, certificate comparisons, pruning) are not instrumented: the
+ * profile splits the search at the hooks bliss calls back into.
+ */
+struct SearchProfile {
+  double total_time = 0;
+  /** Time spent handling generators, including the *report* callable. */
+  double report_time = 0;
+  /** Time spent in the user's *terminate* callable. */
+  double terminate_time = 0;
+  /** Time spent in the progress hook. */
+  double progress_time = 0;
+  /**
+   * When the search reached its first node, i.e. after the refinement of
+   * the root partition, and when it found its first generator. Negative if
+   * it did not happen.
+   */
+  double first_node_time = -1;
+  double first_generator_time = -1;
+  uint64_t n_nodes = 0;
+  uint64_t n_generators = 0;
+  uint64_t n_progress_calls = 0;
+  uint64_t peak_rss = 0;
+};
+
+/**
+ * The :class:`Stats` exposed to Python: bliss's statistics, plus what
+ * pybliss records about a search on top of them.
+ */
+struct PyStats : bliss::Stats {
+  /**
+   * Statistics of a search that pybliss assembled from several bliss
+   * searches, e.g. a parallel search. They take precedence over the ones
+   * bliss recorded in the base class.
+   */
+  struct Combined {
+    bliss::BigNum group_size;
+    long double group_size_approx = 1;
+    uint64_t n_nodes = 0;
+    uint64_t n_leaf_nodes = 0;
+    uint64_t n_bad_nodes = 0;
+    uint64_t n_canupdates = 0;
+    uint64_t n_generators = 0;
+    uint64_t max_level = 0;
+
+    void add(const bliss::Stats &stats) {
+      n_nodes += stats.get_nof_nodes();
+      n_leaf_nodes += stats.get_nof_leaf_nodes();
+      n_bad_nodes += stats.get_nof_bad_nodes();
+      n_canupdates += stats.get_nof_canupdates();
+      max_level = std::max<uint64_t>(max_level, stats.get_max_level());
+    }
+  };
+
+  /**
+   * Why the last search stopped before completing, or nullptr if it
+   * completed. One of the names of the SearchLimits members, or
+   * "terminate" if the user's *terminate* callable asked for it.
+   */
+  const char *stop_reason = nullptr;
+  std::optional<Combined> combined;
+  /**
+   * The index, in the portfolio of splitting heuristics raced by the last
+   * search, of the heuristic whose search finished first.
+   */
+  std::optional<size_t> portfolio_winner;
+
+  /**
+   * Whether searches record their SearchProfile in *profile*, which costs a
+   * clock read at every search tree node.
+   */
+  bool profiling = false;
+  std::optional<SearchProfile> profile;
+  /**
+   * If set, called with the profile so far about every *progress_interval*
+   * seconds during a search, from the thread running the search. Implies
+   * profiling.
+   */
+  std::function<void(const SearchProfile &)> progress;
+  double progress_interval = 1;
+
+  /**
+   * Forgets what pybliss recorded about the previous search.
+   */
+  void begin_search() {
+    stop_reason = nullptr;
+    combined.reset();
+    portfolio_winner.reset();
+    profile.reset();
+  }
+
+  const bliss::BigNum &group_size() const {
+    return combined ? combined->group_size : get_group_size();
+  }
+  long double group_size_approx() const {
+    return combined ? combined->group_size_approx : get_group_size_approx();
+  }
+  uint64_t n_nodes() const {
+    return combined ? combined->n_nodes : get_nof_nodes();
+  }
+  uint64_t n_leaf_nodes() const {
+    return combined ? combined->n_leaf_nodes : get_nof_leaf_nodes();
+  }
+  uint64_t n_bad_nodes() const {
+    return combined ? combined->n_bad_nodes : get_nof_bad_nodes();
+  }
+  uint64_t n_canupdates() const {
+    return combined ? combined->n_canupdates : get_nof_canupdates();
+  }
+  uint64_t n_generators() const {
+    return combined ? combined->n_generators : get_nof_generators();
+  }
+  uint64_t max_level() const {
+    return combined ? combined->max_level : get_max_level();
+  }
+
+  /**
+   * Prints the statistics to \p fp in the format of bliss::Stats::print.
+   */
+  void print(FILE *const fp) const {
+    if (!combined) {
+      bliss::Stats::print(fp);
+      return;
+    }
+    fprintf(fp, "Nodes:          %llu\n", (unsigned long long)n_nodes());
+    fprintf(fp, "Leaf nodes:     %llu\n", (unsigned long long)n_leaf_nodes());
+    fprintf(fp, "Bad nodes:      %llu\n", (unsigned long long)n_bad_nodes());
+    fprintf(fp, "Canrep updates: %llu\n", (unsigned long long)n_canupdates());
+    fprintf(fp, "Generators:     %llu\n", (unsigned long long)n_generators());
+    fprintf(fp, "Max level:      %llu\n", (unsigned long long)max_level());
+    fprintf(fp, "|Aut|:          ");
+    group_size().print(fp);
+    fprintf(fp, "\n");
+  }
+};
+
+/**
+ * Budgets for a single search, checked natively at every search tree node.
+ */
+struct SearchLimits {
+  std::optional<double> time_limit;
+  std::optional<uint64_t> max_nodes;
+  std::optional<uint64_t> max_generators;
+  const CancellationToken *cancel = nullptr;
+};
+
+/**
+ * Builds the report and terminate hooks handed to bliss for a search under
+ * \p limits. The hooks forward to \p report and \p terminate (either may be
+ * empty) and record in \p stats why the search was cut short, if it was.
+ * Must outlive the search.
+ *
+ * The hooks may be shared by searches running concurrently on several
+ * threads, in which case the budgets apply to all of them together.
+ *
+ * If \p stats asks for profiling, the hooks also time themselves, and the
+ * SearchProfile is stored in \p stats when the monitor is destroyed.
+ */
+class SearchMonitor {
+public:
+  using ReportFunction =
+      std::function<void(unsigned int, const unsigned int *)>;
+
+  SearchMonitor(const SearchLimits &limits, PyStats &stats,
+                ReportFunction report, std::function<bool()> terminate)
+      : limits(limits), stats(stats), user_report(std::move(report)),
+        user_terminate(std::move(terminate)),
+        profiling(stats.profiling || stats.progress),
+        start(std::chrono::steady_clock::now()),
+        deadline(limits.time_limit
+                     ? start + std::chrono::duration_cast<
+                                   std::chrono::steady_clock::duration>(
+                                   std::chrono::duration<double>(
+                                       *limits.time_limit))
+                     : std::chrono::steady_clock::time_point::max()),
+        progress_interval_ns((int64_t)(stats.progress_interval * 1e9)),
+        next_progress_ns(progress_interval_ns) {
+    stats.begin_search();
+  }
+
+  ~SearchMonitor() {
+    if (profiling) {
+      stats.profile = snapshot(elapsed_ns());
+    }
+  }
+
+  /**
+   * Returns true once one of the hooks asked for the search to stop.
+   */
+  bool is_stopped() const {
+    return reason.load(std::memory_order_acquire) != nullptr;
+  }
+
+  const SearchLimits &get_limits() const { return limits; }
+
+  /**
+   * Records \p why as the reason for stopping, unless another hook already
+   * stopped the search, and returns true.
+   */
+  bool stop(const char *why) {
+    const char *expected = nullptr;
+    if (reason.compare_exchange_strong(expected, why,
+                                       std::memory_order_acq_rel)) {
+      stats.stop_reason = why;
+    }
+    return true;
+  }
+
+  /**
+   * Returns the report hook, or an empty function if there is nothing to
+   * observe, so that bliss can skip it.
+   */
+  ReportFunction report() {
+    if (!user_report && !limits.max_generators && !profiling) {
+      return nullptr;
+    }
+    return [this](unsigned int n, const unsigned int *aut) {
+      n_generators.fetch_add(1, std::memory_order_relaxed);
+      PhaseTimer timer(*this, report_ns);
+      if (profiling) {
+        record_first(first_generator_ns, timer.begin);
+      }
+      if (user_report) {
+        user_report(n, aut);
+      }
+    };
+  }
+
+  /**
+   * Returns the terminate hook, or an empty function if the search is
+   * unbounded.
+   */
+  std::function<bool()> terminate() {
+    if (!user_terminate && !limits.time_limit && !limits.max_nodes &&
+        !limits.max_generators && !limits.cancel && !profiling) {
+      return nullptr;
+    }
+    return [this]() {
+      const uint64_t node = n_nodes.fetch_add(1, std::memory_order_relaxed);
+      if (profiling) {
+        const int64_t now = elapsed_ns();
+        record_first(first_node_ns, now);
+        sample_progress(now);
+      }
+      if (is_stopped()) {
+        return true;
+      }
+      if (limits.cancel && limits.cancel->is_cancelled()) {
+        return stop("cancel");
+      }
+      if (limits.max_nodes && node >= *limits.max_nodes) {
+        return stop("max_nodes");
+      }
+      if (limits.max_generators &&
+          n_generators.load(std::memory_order_relaxed) >=
+              *limits.max_generators) {
+        return stop("max_generators");
+      }
+      if (limits.time_limit && std::chrono::steady_clock::now() > deadline) {
+        return stop("time_limit");
+      }
+      if (user_terminate) {
+        PhaseTimer timer(*this, terminate_ns);
+        if (user_terminate()) {
+          return stop("terminate");
+        }
+      }
+      return false;
+    };
+  }
+
+private:
+  /**
+   * Adds the time from its construction to its destruction to a timer of
+   * the monitor, if profiling.
+   */
+  struct PhaseTimer {
+    PhaseTimer(SearchMonitor &monitor, std::atomic<int64_t> &total)
+        : monitor(monitor), total(total),
+          begin(monitor.profiling ? monitor.elapsed_ns() : 0) {}
+    ~PhaseTimer() {
+      if (monitor.profiling) {
+        total.fetch_add(monitor.elapsed_ns() - begin,
+                        std::memory_order_relaxed);
+      }
+    }
+
+    SearchMonitor &monitor;
+    std::atomic<int64_t> &total;
+    const int64_t begin;
+  };
+
+  int64_t elapsed_ns() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+  }
+
+  static void record_first(std::atomic<int64_t> &first, int64_t now) {
+    int64_t unset = -1;
+    if (first.load(std::memory_order_relaxed) == unset) {
+      first.compare_exchange_strong(unset, now, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Calls the progress hook of the stats if it is due at \p now. Of the
+   * threads reaching it concurrently, only one calls it.
+   */
+  void sample_progress(int64_t now) {
+    if (!stats.progress) {
+      return;
+    }
+    int64_t next = next_progress_ns.load(std::memory_order_relaxed);
+    if (now < next || !next_progress_ns.compare_exchange_strong(
+                          next, now + progress_interval_ns,
+                          std::memory_order_relaxed)) {
+      return;
+    }
+    PhaseTimer timer(*this, progress_ns);
+    n_progress_calls.fetch_add(1, std::memory_order_relaxed);
+    stats.progress(snapshot(now));
+  }
+
+  SearchProfile snapshot(int64_t now) const {
+    auto seconds = [](int64_t ns) { return ns < 0 ? -1.0 : ns * 1e-9; };
+    SearchProfile profile;
+    profile.total_time = seconds(now);
+    profile.report_time = seconds(report_ns.load(std::memory_order_relaxed));
+    profile.terminate_time =
+        seconds(terminate_ns.load(std::memory_order_relaxed));
+    profile.progress_time =
+        seconds(progress_ns.load(std::memory_order_relaxed));
+    profile.first_node_time =
+        seconds(first_node_ns.load(std::memory_order_relaxed));
+    profile.first_generator_time =
+        seconds(first_generator_ns.load(std::memory_order_relaxed));
+    profile.n_nodes = n_nodes.load(std::memory_order_relaxed);
+    profile.n_generators = n_generators.load(std::memory_order_relaxed);
+    profile.n_progress_calls = n_progress_calls.load(std::memory_order_relaxed);
+    profile.peak_rss = peak_rss_bytes();
+    return profile;
+  }
+
+  const SearchLimits &limits;
+  PyStats &stats;
+  ReportFunction user_report;
+  std::function<bool()> user_terminate;
+  const bool profiling;
+  const std::chrono::steady_clock::time_point start;
+  const std::chrono::steady_clock::time_point deadline;
+  std::atomic<uint64_t> n_nodes{0};
+  std::atomic<uint64_t> n_generators{0};
+  std::atomic<const char *> reason{nullptr};
+
+  // Profiling, in nanoseconds since start.
+  const int64_t progress_interval_ns;
+  std::atomic<int64_t> next_progress_ns;
+  std::atomic<int64_t> report_ns{0};
+  std::atomic<int64_t> terminate_ns{0};
+  std::atomic<int64_t> progress_ns{0};
+  std::atomic<int64_t> first_node_ns{-1};
+  std::atomic<int64_t> first_generator_ns{-1};
+  std::atomic<uint64_t> n_progress_calls{0};
+};
+
+using PyReportFunction = std::function<void(
+    int,
+    nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy, nb::c_contig>)>;
+
+/**
+ * Returns the bliss-side automorphism hook that reports to \p py_report the
+ * first \p nvertices entries of every generator, i.e. the whole generator
+ * for a plain graph, or its restriction to the original vertices for an
+ * encoding with extra vertices. The search runs with the GIL released, so
+ * the hook re-acquires it only for the duration of the Python call. Returns
+ * an empty function when no *report* was passed so that bliss skips the
+ * hook entirely.
+ */
+inline SearchMonitor::ReportFunction
+wrap_py_report(const std::optional<const PyReportFunction> &py_report,
+               unsigned int nvertices) {
+  if (!py_report) {
+    return nullptr;
+  }
+  return [&py_report, nvertices](unsigned int, const unsigned int *aut) {
+    nb::gil_scoped_acquire acquire;
+    (*py_report)(
+        nvertices,
+        nb::ndarray<nb::ro, uint32_t, nb::ndim<1>, nb::numpy, nb::c_contig>(
+            aut, {nvertices}));
+  };
+}
+
+/**
+ * Returns the bliss-side termination hook that forwards to \p py_terminate,
+ * holding the GIL only while the Python callable runs.
+ */
+inline std::function<bool()> wrap_py_terminate(
+    const std::optional<const std::function<bool()>> &py_terminate) {
+  if (!py_terminate) {
+    return nullptr;
+  }
+  return [&py_terminate]() {
+    nb::gil_scoped_acquire acquire;
+    return (*py_terminate)();
+  };
+}
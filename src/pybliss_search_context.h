@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <pybliss_certificate.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Scratch memory reused by the searches it is passed to, so that repeated
+ * searches on graphs of similar sizes do not allocate it every time. A
+ * context may be passed to one search at a time only.
+ */
+class SearchContext {
+public:
+  /**
+   * Marks \p context as used by a search for the lifetime of the lease.
+   * Throws std::runtime_error if another search is using it.
+   */
+  class Lease {
+  public:
+    explicit Lease(SearchContext &context) : context(context) {
+      if (context.in_use.exchange(true, std::memory_order_acquire)) {
+        throw std::runtime_error(
+            "The SearchContext is already in use by another search.");
+      }
+    }
+    ~Lease() { context.in_use.store(false, std::memory_order_release); }
+    Lease(const Lease &) = delete;
+    Lease &operator=(const Lease &) = delete;
+
+  private:
+    SearchContext &context;
+  };
+
+  /**
+   * Returns the number of bytes of scratch memory currently held.
+   */
+  size_t nbytes() const {
+    size_t n = scratch_nbytes(certificate_scratch) + certificate.capacity() +
+               labeling.capacity() * sizeof(unsigned int);
+    for (const CertificateScratch &scratch : branch_scratch) {
+      n += scratch_nbytes(scratch);
+    }
+    return n;
+  }
+
+  /**
+   * Frees the scratch memory.
+   */
+  void clear() {
+    Lease lease(*this);
+    certificate_scratch = CertificateScratch();
+    certificate = std::string();
+    labeling = std::vector<unsigned int>();
+    branch_scratch = std::vector<CertificateScratch>();
+  }
+
+  CertificateScratch certificate_scratch;
+  std::string certificate;
+  /// The canonical labeling found by a parallel search.
+  std::vector<unsigned int> labeling;
+  /// The certificate scratch of every worker of a parallel search.
+  std::vector<CertificateScratch> branch_scratch;
+
+private:
+  static size_t scratch_nbytes(const CertificateScratch &scratch) {
+    return scratch.offsets.capacity() * sizeof(size_t) +
+           scratch.fill.capacity() * sizeof(size_t) +
+           scratch.adjacency.capacity() * sizeof(unsigned int) +
+           scratch.colors.capacity() * sizeof(uint32_t);
+  }
+
+  std::atomic<bool> in_use{false};
+};
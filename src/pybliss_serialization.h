@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include <pybliss_graph_access.h>
+#include <pybliss_io.h>
+#include <vector>
+
+/**
+ * Returns the binary encoding of \p g used by ``to_bytes`` and pickling:
+ *
+ * - the magic bytes ``PBLG`` and a format version byte (currently 1),
+ * - a byte that is 0 for a Graph and 1 for a Digraph,
+ * - a byte of flags for failure recording (bit 0), component recursion
+ *   (bit 1) and long prune (bit 2), and a byte for the splitting heuristic,
+ * - N and the N vertex colors as LEB128 varints,
+ * - for every vertex, its number of out-neighbors and the gaps between its
+ *   sorted out-neighbors, as varints. For a Graph, the neighbors of v are
+ *   those that are at least v and the first gap is taken from v, every
+ *   edge being listed once.
+ *
+ * Normalizes \p g (see GraphAccess::normalize), so duplicate edges are not
+ * encoded. May be called without the GIL.
+ */
+template <typename GraphT> std::vector<uint8_t> serialize_graph(GraphT &g);
+
+/**
+ * Decodes the encoding of a GraphT produced by serialize_graph in [\p data,
+ * \p data + \p size) into \p parsed and \p options. Throws
+ * std::runtime_error on malformed input, on an unsupported format version,
+ * and on the encoding of the other graph type. May be called without the
+ * GIL.
+ */
+template <typename GraphT>
+void deserialize_graph(const uint8_t *data, size_t size, ParsedGraph &parsed,
+                       typename GraphAccess<GraphT>::SearchOptions &options);
@@ -0,0 +1,91 @@
+import numpy as np
+
+import pybliss as bliss
+
+
+def _random_graphs(n_graphs, N, seed=0):
+    rng = np.random.default_rng(seed=seed)
+    graphs = []
+    for _ in range(n_graphs):
+        E = np.argwhere(np.triu(rng.random((N, N)) < 0.3, k=1))
+        graphs.append(bliss.graph_from_numpy(N, E, np.zeros(N, dtype=int)))
+    return graphs
+
+
+def test_canonicalize_many():
+    graphs = _random_graphs(50, 12)
+    # repeated entries must be handled as well.
+    graphs.append(graphs[0])
+
+    labelings, stats = bliss.canonicalize_many(graphs, n_threads=4)
+
+    assert labelings.shape == (len(graphs), 12)
+    assert labelings.dtype == np.uint32
+    for i, g in enumerate(graphs):
+        s = bliss.Stats()
+        np.testing.assert_array_equal(
+            labelings[i], g.copy().get_permutation_to_canonical_form(s)
+        )
+        assert stats["n_nodes"][i] == s.n_nodes
+        assert stats["group_size_approx"][i] == s.group_size_approx
+
+
+def test_canonicalize_many_digraph():
+    pentagon = bliss.Digraph(5)
+    relabeled_pentagon = bliss.Digraph(5)
+    for i in range(5):
+        pentagon.add_edge(i, (i + 1) % 5)
+        relabeled_pentagon.add_edge((2 * i) % 5, (2 * i + 2) % 5)
+
+    labelings, _ = bliss.canonicalize_many(
+        [pentagon, relabeled_pentagon],
+        splitting_heuristic=bliss.Digraph.SplittingHeuristic.shs_f,
+    )
+    assert pentagon.permute(labelings[0]) == relabeled_pentagon.permute(
+        labelings[1]
+    )
+
+
+def test_refinement_invariants():
+    graphs = _random_graphs(30, 10)
+    rng = np.random.default_rng(seed=1)
+    perms = [rng.permutation(10).astype(np.uint32) for _ in graphs]
+    permuted = [g.permute(p) for g, p in zip(graphs, perms)]
+    graphs.append(graphs[0])
+
+    hashes = bliss.refinement_invariants(graphs + permuted, n_threads=4)
+    assert hashes[: len(graphs)] == [
+        g.refinement_invariant()[0] for g in graphs
+    ]
+    assert hashes[: len(permuted)] == hashes[len(graphs) :]
+
+    for g, p, h in zip(graphs, perms, permuted):
+        _, colors = g.refinement_invariant()
+        _, permuted_colors = h.refinement_invariant()
+        np.testing.assert_array_equal(permuted_colors[p], colors)
+
+    # Color refinement does not tell regular graphs apart.
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    prism = bliss.Graph(10)
+    for i in range(5):
+        prism.add_edge(i, (i + 1) % 5)
+        prism.add_edge(5 + i, 5 + (i + 1) % 5)
+        prism.add_edge(i, 5 + i)
+    h1, c1 = petersen.refinement_invariant()
+    h2, c2 = prism.refinement_invariant()
+    assert h1 == h2
+    assert not c1.any() and not c2.any()
+    path = bliss.Graph(3)
+    path.add_edge(0, 1)
+    path.add_edge(1, 2)
+    hash_, colors = path.refinement_invariant()
+    assert colors.tolist() == [0, 1, 0]
+    assert hash_ != bliss.refinement_invariants([bliss.Graph(3)])[0]
+
+    # A long path needs many splits, each only revisiting a few vertices.
+    n = 100_000
+    edges = np.stack([np.arange(n - 1), np.arange(1, n)], axis=1)
+    long_path = bliss.Graph.from_edge_array(n, edges.astype(np.uint32))
+    _, colors = long_path.refinement_invariant()
+    np.testing.assert_array_equal(colors, colors[::-1])
+    assert len(np.unique(colors)) == n // 2
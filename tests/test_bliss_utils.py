@@ -76,3 +76,17 @@ def test_digraph_to_numpy_0():
     pentagon_1 = bliss.digraph_from_numpy(5, *bliss.graph_to_numpy(pentagon_0))
 
     assert pentagon_0 == pentagon_1
+
+
+def test_permutation_to_str():
+    perm = np.array([1, 0, 3, 4, 2], dtype=np.uint32)
+    assert bliss.permutation_to_str(perm) == "(0,1)(2,3,4)"
+    assert bliss.permutation_to_str(perm, offset=1) == "(1,2)(3,4,5)"
+
+
+def test_bignum_to_int():
+    n = bliss.BigNum()
+    n.assign(6)
+    n.multiply(7)
+    assert int(n) == 42
+    assert str(n) == "42"
@@ -0,0 +1,93 @@
+import struct
+
+import numpy as np
+import pytest
+
+import pybliss as bliss
+
+
+def _random_relabelings(g, n, seed=0):
+    rng = np.random.default_rng(seed)
+    return [
+        g.permute(rng.permutation(g.nvertices).astype(np.uint32))
+        for _ in range(n)
+    ]
+
+
+def test_canonical_index(tmp_path):
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    cycle = bliss.Graph.from_edge_array(
+        10, np.array([[i, (i + 1) % 10] for i in range(10)], dtype=np.uint32)
+    )
+
+    index = bliss.CanonicalIndex()
+    assert index.insert(petersen) == (0, True)
+    assert index.insert(petersen.copy()) == (0, False)
+    assert cycle not in index
+    assert index.class_id(cycle) is None
+
+    graphs = _random_relabelings(petersen, 5) + _random_relabelings(cycle, 5)
+    graphs.append(graphs[-1])
+    class_ids, is_new = index.insert_many(graphs, n_threads=3)
+    assert class_ids.dtype == np.uint64
+    assert class_ids.tolist() == [0] * 5 + [1] * 6
+    assert is_new.tolist() == [False] * 5 + [True] + [False] * 5
+
+    assert len(index) == 2
+    assert index.contains(cycle)
+    assert index.class_id(cycle) == 1
+    assert index.certificate(0) == petersen.canonical_certificate(
+        bliss.Stats()
+    )[0]
+
+    # graphs and digraphs are distinct classes
+    assert bliss.Digraph(10) not in index
+    assert index.insert(bliss.Digraph(10)) == (2, True)
+
+    path = tmp_path / "index.bin"
+    index.save(path)
+    loaded = bliss.CanonicalIndex.load(path)
+    assert len(loaded) == 3
+    assert loaded.class_id(cycle) == 1
+    assert loaded.insert(bliss.Graph(10)) == (3, True)
+    assert len(bliss.CanonicalIndex.load(path)) == 3
+
+
+def test_canonical_index_corrupt_file(tmp_path):
+    index = bliss.CanonicalIndex()
+    for g in [bliss.Graph.from_graph6(b"IheA@GUAo"), bliss.Graph(3)]:
+        index.insert(g)
+    path = tmp_path / "index.bin"
+    index.save(path)
+    data = path.read_bytes()
+
+    # The header is followed by the slots and the certificate offsets.
+    header_size = 40
+    n_classes, n_slots, arena_size = struct.unpack_from("=QQQ", data, 16)
+    slots = np.frombuffer(data, np.uint64, n_slots, header_size)
+    occupied = np.flatnonzero(slots)
+    offsets_start = header_size + 8 * n_slots
+
+    def tampered(offset, fmt, *values):
+        buf = bytearray(data)
+        struct.pack_into(fmt, buf, offset, *values)
+        return bytes(buf)
+
+    full = bytearray(data)
+    for islot in np.flatnonzero(slots == 0):
+        struct.pack_into(
+            "=Q", full, header_size + 8 * int(islot), int(slots[occupied[0]])
+        )
+    corrupt = [
+        data[:-1],
+        # Sizes for which the expected file size wraps around.
+        tampered(24, "=QQ", 2**61, arena_size + 8 * n_slots),
+        tampered(header_size + 8 * int(occupied[0]), "=Q", n_classes + 1),
+        tampered(offsets_start + 8, "=Q", arena_size + 1),
+        bytes(full),
+    ]
+    for i, contents in enumerate(corrupt):
+        corrupt_path = tmp_path / f"corrupt{i}.bin"
+        corrupt_path.write_bytes(contents)
+        with pytest.raises(RuntimeError, match="Corrupt"):
+            bliss.CanonicalIndex.load(corrupt_path)
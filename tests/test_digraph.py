@@ -1,3 +1,5 @@
+import numpy as np
+
 import pybliss as bliss
 
 
@@ -52,3 +54,34 @@ def test_change_color_get_color():
 
 
 # TODO: Add tests for Digraph.get_caonnical_from, Digraph.find_automorphisms.
+
+
+def test_from_edge_array():
+    pentagon = bliss.Digraph(5)
+    for i in range(5):
+        pentagon.add_edge(i, (i + 1) % 5)
+
+    E = np.array([[i, (i + 1) % 5] for i in range(5)], dtype=np.uint32)
+    assert bliss.Digraph.from_edge_array(5, E) == pentagon
+    # reversed edges give a different digraph
+    assert bliss.Digraph.from_edge_array(5, E[:, ::-1].copy()) != pentagon
+
+
+def test_digraph6():
+    g = bliss.Digraph.from_digraph6("&DI?AO?")
+    E, _ = g.to_edge_array()
+    assert sorted(map(tuple, E.tolist())) == [(0, 2), (0, 4), (3, 1), (3, 4)]
+    assert g.to_digraph6() == b"&DI?AO?"
+    assert list(bliss.Digraph.iter_digraph6(b"&DI?AO?\n&DI?AO?\n")) == [g, g]
+
+
+def test_pickle():
+    import pickle
+
+    g = bliss.Digraph.from_edge_array(
+        4,
+        np.array([[0, 1], [1, 0], [2, 3], [3, 3]], dtype=np.uint32),
+        np.array([2, 0, 0, 1], dtype=np.uint32),
+    )
+    assert bliss.Digraph.from_bytes(g.to_bytes()) == g
+    assert pickle.loads(pickle.dumps(g, protocol=5)) == g
@@ -0,0 +1,82 @@
+import numpy as np
+import pytest
+
+import pybliss as bliss
+
+
+def _colored_cycle(n, colors):
+    return np.array(
+        [[i, (i + 1) % n, colors[i % len(colors)]] for i in range(n)],
+        dtype=np.uint32,
+    )
+
+
+@pytest.mark.parametrize("encoding", ["auto", "layered", "subdivision"])
+@pytest.mark.parametrize(
+    "cls", [bliss.EdgeColoredGraph, bliss.EdgeColoredDigraph]
+)
+def test_edge_colored_canonical_form(cls, encoding):
+    # A 6-cycle with alternating edge colors, a doubled edge and a loop.
+    edges = np.vstack([
+        _colored_cycle(6, [1, 2]),
+        np.array([[0, 3, 7], [0, 3, 7], [2, 2, 5]], dtype=np.uint32),
+    ])
+    g = cls(6, edges, encoding=encoding)
+    assert g.nvertices == 6
+    assert g.nedges == 9
+    assert g.encoding in ("layered", "subdivision")
+    np.testing.assert_array_equal(g.to_edge_array()[0], edges)
+
+    rng = np.random.default_rng(0)
+    perm = rng.permutation(6).astype(np.uint32)
+    h = g.permute(perm)
+    assert h.encoding == g.encoding
+    lab_g = g.get_permutation_to_canonical_form(bliss.Stats())
+    lab_h = h.get_permutation_to_canonical_form(bliss.Stats())
+    assert g.permute(lab_g) == h.permute(lab_h)
+    assert g.canonical_certificate(bliss.Stats()) == (
+        h.canonical_certificate(bliss.Stats())
+    )
+
+    # Recoloring one of the parallel edges gives a non-isomorphic graph.
+    edges[6, 2] = 8
+    other = cls(6, edges, encoding=encoding)
+    assert other.canonical_certificate(bliss.Stats()) != (
+        g.canonical_certificate(bliss.Stats())
+    )
+
+
+def test_edge_colored_automorphisms():
+    # Alternating colors leave the rotations by an even number of steps and
+    # the reflections through the midpoints of opposite edges of the 6-cycle:
+    # a group of order 6.
+    g = bliss.EdgeColoredGraph(6, _colored_cycle(6, [1, 2]))
+    assert g.encoding == "layered"
+    stats = bliss.Stats()
+    generators = g.automorphism_generators(stats)
+    assert generators.shape[1] == 6
+    assert stats.group_size == 6
+    for aut in generators:
+        assert g.is_automorphism(aut)
+
+    reported = []
+    g.find_automorphisms(
+        bliss.Stats(), lambda n, aut: reported.append(aut.copy())
+    )
+    np.testing.assert_array_equal(np.array(reported), generators)
+
+    # With a single edge color, the encoding is the graph itself.
+    single = bliss.EdgeColoredGraph(6, _colored_cycle(6, [1]))
+    assert single.to_encoded_graph().nvertices == 6
+    single.automorphism_generators(stats)
+    assert stats.group_size == 12
+
+    # Every edge has its own color: subdividing is cheaper than 3 layers.
+    rainbow = bliss.EdgeColoredDigraph(6, _colored_cycle(6, range(6)))
+    assert rainbow.encoding == "subdivision"
+    assert rainbow.to_encoded_graph().nvertices == 12
+
+    with pytest.raises(RuntimeError):
+        bliss.EdgeColoredGraph(2, np.array([[0, 2, 0]], dtype=np.uint32))
+    with pytest.raises(RuntimeError):
+        bliss.EdgeColoredGraph(2, np.zeros((1, 3), np.uint32), encoding="x")
@@ -1,4 +1,7 @@
+from concurrent.futures import ThreadPoolExecutor
+
 import numpy as np
+import pytest
 
 import pybliss as bliss
 
@@ -133,3 +136,606 @@ def test_change_color_get_color():
 
     for i in range(3):
         assert k3.get_color(i) == i
+
+
+def test_concurrent_canonical_form():
+    rng = np.random.default_rng(seed=0)
+    graphs = []
+    for _ in range(16):
+        N = 30
+        E = np.argwhere(np.triu(rng.random((N, N)) < 0.2, k=1))
+        graphs.append(bliss.graph_from_numpy(N, E, np.zeros(N, dtype=int)))
+
+    def canonical_perm(g):
+        return g.get_permutation_to_canonical_form(bliss.Stats())
+
+    expected = [canonical_perm(g.copy()) for g in graphs]
+
+    with ThreadPoolExecutor(max_workers=4) as pool:
+        results = list(pool.map(canonical_perm, graphs))
+
+    for perm, expected_perm in zip(results, expected):
+        np.testing.assert_array_equal(perm, expected_perm)
+
+
+def test_from_edge_array():
+    pentagon = bliss.Graph(5)
+    for i in range(5):
+        pentagon.add_edge(i, (i + 1) % 5)
+        pentagon.change_color(i, i % 2)
+
+    E = np.array([[i, (i + 1) % 5] for i in range(5)], dtype=np.uint32)
+    c = np.array([i % 2 for i in range(5)], dtype=np.uint32)
+    assert bliss.Graph.from_edge_array(5, E, c) == pentagon
+
+    g = bliss.Graph(5)
+    g.add_edges(E)
+    g.set_colors(c)
+    assert g == pentagon
+
+    with pytest.raises(RuntimeError):
+        g.add_edges(np.array([[0, 5]], dtype=np.uint32))
+
+
+def test_to_edge_array_to_csr():
+    pentagon = bliss.Graph(5)
+    for i in range(5):
+        pentagon.add_edge(i, (i + 1) % 5)
+        pentagon.change_color(i, i)
+    # duplicate edges are ignored.
+    pentagon.add_edge(1, 0)
+
+    E, c = pentagon.to_edge_array()
+    assert E.shape == (5, 2)
+    assert E.dtype == np.uint32
+    assert np.all(E[:, 0] <= E[:, 1])
+    np.testing.assert_array_equal(c, np.arange(5))
+    assert bliss.Graph.from_edge_array(5, E, c) == pentagon
+
+    indptr, indices, c = pentagon.to_csr()
+    np.testing.assert_array_equal(indptr, 2 * np.arange(6))
+    np.testing.assert_array_equal(indices[indptr[0] : indptr[1]], [1, 4])
+
+
+def test_from_dimacs_sources(tmp_path):
+    import gzip
+    import io
+    import os
+
+    pentagon = bliss.Graph(5)
+    for i in range(5):
+        pentagon.add_edge(i, (i + 1) % 5)
+    pentagon.change_color(2, 7)
+    dimacs = pentagon.to_dimacs().encode()
+
+    assert bliss.Graph.from_dimacs(dimacs) == pentagon
+    assert bliss.Graph.from_dimacs(io.BytesIO(dimacs)) == pentagon
+    assert bliss.Graph.from_dimacs(io.StringIO(dimacs.decode())) == pentagon
+
+    with gzip.open(tmp_path / "pentagon.dimacs.gz", "wb") as fp:
+        fp.write(dimacs)
+    with gzip.open(tmp_path / "pentagon.dimacs.gz", "rb") as fp:
+        assert bliss.Graph.from_dimacs(fp) == pentagon
+
+    (tmp_path / "pentagon.dimacs").write_bytes(dimacs)
+    assert bliss.Graph.from_dimacs(tmp_path / "pentagon.dimacs") == pentagon
+
+    # file objects are read from their current position, after a skipped
+    # header line, and left at their end
+    (tmp_path / "header.dimacs").write_bytes(b"not dimacs\n" + dimacs)
+    for mode in ["rb", "r"]:
+        with open(tmp_path / "header.dimacs", mode) as fp:
+            next(fp)
+            assert bliss.Graph.from_dimacs(fp) == pentagon
+            assert not fp.read()
+    with open(tmp_path / "header.dimacs", "rb", buffering=0) as fp:
+        fp.readline()
+        assert bliss.Graph.from_dimacs(fp) == pentagon
+        assert fp.read() == b""
+
+    # pipes are read as streams, whether given as file objects or as paths
+    for mode in ["rb", "r"]:
+        read_fd, write_fd = os.pipe()
+        os.write(write_fd, dimacs)
+        os.close(write_fd)
+        with open(read_fd, mode) as fp:
+            assert bliss.Graph.from_dimacs(fp) == pentagon
+    if os.path.exists("/dev/fd"):
+        read_fd, write_fd = os.pipe()
+        os.write(write_fd, dimacs)
+        os.close(write_fd)
+        try:
+            path = f"/dev/fd/{read_fd}"
+            assert bliss.Graph.from_dimacs(path) == pentagon
+        finally:
+            os.close(read_fd)
+
+    with pytest.raises(RuntimeError):
+        bliss.Graph.from_dimacs(b"p edge 2 1\ne 1 3\n")
+
+
+def test_iter_dimacs():
+    graphs = []
+    for n in range(3, 7):
+        cycle = bliss.Graph(n)
+        for i in range(n):
+            cycle.add_edge(i, (i + 1) % n)
+        graphs.append(cycle)
+
+    src = "c a few cycles\n" + "".join(g.to_dimacs() for g in graphs)
+    assert list(bliss.Graph.iter_dimacs(src.encode())) == graphs
+
+
+def test_graph6_sparse6():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    assert petersen.nvertices == 10
+    assert petersen.to_graph6() == b"IheA@GUAo"
+    assert bliss.Graph.from_graph6(petersen.to_sparse6()) == petersen
+
+    s = bliss.Stats()
+    perm = petersen.get_permutation_to_canonical_form(s)
+    assert petersen.to_graph6(perm) == petersen.permute(perm).to_graph6()
+
+    lines = b">>graph6<<DQc\n:Fa@x^\n\nD~{\n"
+    graphs = list(bliss.Graph.iter_graph6(lines))
+    assert [g.nvertices for g in graphs] == [5, 7, 5]
+    assert graphs[1].to_sparse6() == b":Fa@x^"
+
+
+def test_canonical_certificate():
+    g = bliss.Graph.from_graph6(b"IheA@GUAo")
+    perm = np.random.default_rng(0).permutation(g.nvertices).astype(np.uint32)
+    h = g.permute(perm)
+    h.change_color(0, 1)
+
+    cert_g, hash_g = g.canonical_certificate(bliss.Stats())
+    cert_pg, hash_pg = g.permute(perm).canonical_certificate(bliss.Stats())
+    cert_h, hash_h = h.canonical_certificate(bliss.Stats())
+
+    assert isinstance(cert_g, bytes)
+    assert 0 <= hash_g < 2**128
+    assert (cert_g, hash_g) == (cert_pg, hash_pg)
+    assert cert_g != cert_h and hash_g != hash_h
+
+    # graphs and digraphs never share certificates
+    cert_empty, _ = bliss.Graph(3).canonical_certificate(bliss.Stats())
+    cert_empty_d, _ = bliss.Digraph(3).canonical_certificate(bliss.Stats())
+    assert cert_empty != cert_empty_d
+
+
+def test_automorphism_generators():
+    g = bliss.Graph.from_graph6(b"IheA@GUAo")
+    reported = []
+    g.find_automorphisms(
+        bliss.Stats(), lambda n, aut: reported.append(aut.copy())
+    )
+
+    stats = bliss.Stats()
+    generators = g.automorphism_generators(stats)
+    assert generators.dtype == np.uint32
+    assert generators.shape == (stats.n_generators, g.nvertices)
+    assert stats.group_size == 120
+    np.testing.assert_array_equal(generators, np.array(reported))
+    assert all(g.is_automorphism(gen) for gen in generators)
+
+    assert bliss.Graph(0).automorphism_generators(bliss.Stats()).shape == (0, 0)
+
+
+def test_search_limits():
+    g = bliss.Graph.from_graph6(b"IheA@GUAo")
+
+    stats = bliss.Stats()
+    g.find_automorphisms(stats, time_limit=60, max_nodes=10**6)
+    assert stats.completed and stats.stop_reason is None
+    assert stats.group_size == 120
+
+    g.find_automorphisms(stats, max_nodes=1)
+    assert not stats.completed and stats.stop_reason == "max_nodes"
+    assert stats.group_size < 120
+
+    generators = g.automorphism_generators(stats, max_generators=1)
+    assert stats.stop_reason == "max_generators"
+    assert generators.shape == (1, g.nvertices)
+
+    token = bliss.CancellationToken()
+    token.cancel()
+    g.get_permutation_to_canonical_form(stats, cancel=token)
+    assert stats.stop_reason == "cancel"
+    token.reset()
+    assert not token.is_cancelled
+    g.get_permutation_to_canonical_form(stats, cancel=token)
+    assert stats.completed
+
+    g.find_automorphisms(stats, terminate=lambda: True)
+    assert stats.stop_reason == "terminate"
+
+
+def test_orbits():
+    # path 0 - 1 - 2 - 3 plus an isolated vertex 4 of another color
+    g = bliss.Graph.from_edge_array(
+        5,
+        np.array([[0, 1], [1, 2], [2, 3]], dtype=np.uint32),
+        np.array([0, 0, 0, 0, 1], dtype=np.uint32),
+    )
+    stats = bliss.Stats()
+    representatives, sizes = g.orbits(stats)
+    assert representatives.tolist() == [0, 1, 1, 0, 4]
+    assert sizes.tolist() == [2, 2, 2, 2, 1]
+    assert stats.group_size == 2
+
+    # the Petersen graph is vertex-transitive, the stabilizer of a vertex
+    # has orbits of sizes 1, 3 and 6
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    _, sizes = petersen.orbits(stats)
+    assert sizes.tolist() == [10] * 10
+    representatives, sizes = petersen.orbits(
+        stats, fixed=np.array([0], dtype=np.uint32)
+    )
+    assert stats.group_size == 12
+    assert representatives[0] == 0
+    assert sorted(set(sizes.tolist())) == [1, 3, 6]
+
+
+def test_parallel_search():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    stats = bliss.Stats()
+    for n_threads in [1, 4]:
+        generators = []
+        petersen.find_automorphisms(
+            stats, lambda n, aut: generators.append(aut), n_threads=n_threads
+        )
+        assert stats.completed
+        assert stats.group_size == 120
+        assert stats.n_generators == len(generators)
+
+    # the labeling does not depend on the number of threads, and isomorphic
+    # graphs get the same parallel canonical form, whatever the heuristic
+    rng = np.random.default_rng(0)
+    perm = rng.permutation(petersen.nvertices).astype(np.uint32)
+    for heuristic in [
+        bliss.Graph.SplittingHeuristic.shs_f,
+        bliss.Graph.SplittingHeuristic.shs_flm,
+    ]:
+        canons = []
+        for g in [petersen.copy(), petersen.permute(perm)]:
+            g.set_splitting_heuristic(heuristic)
+            labelings = [
+                g.parallel_canonical_labeling(stats, n_threads=n_threads)
+                for n_threads in [1, 3]
+            ]
+            assert all(np.array_equal(labelings[0], lab) for lab in labelings)
+            canons.append(g.permute(labelings[0]))
+        assert canons[0] == canons[1]
+
+    # the parallel labeling has its own method
+    with pytest.raises(TypeError):
+        petersen.get_permutation_to_canonical_form(stats, n_threads=2)
+
+
+def test_parallel_search_discrete():
+    # Color refinement distinguishes all the vertices of an asymmetric tree:
+    # the search then runs sequentially and gives the sequential labeling.
+    tree = bliss.Graph.from_edge_array(
+        7,
+        np.array(
+            [(0, 1), (1, 2), (2, 3), (3, 4), (4, 5), (2, 6)], dtype=np.uint32
+        ),
+    )
+    stats = bliss.Stats()
+    np.testing.assert_array_equal(
+        tree.parallel_canonical_labeling(stats, n_threads=4),
+        tree.get_permutation_to_canonical_form(stats),
+    )
+    assert stats.group_size == 1
+
+
+def test_parallel_search_generators():
+    # A 6-cycle and two triangles: refinement keeps all the vertices in one
+    # cell, which splits into two orbits. The branch of a cycle vertex finds
+    # the stabilizer of that vertex, the automorphisms moving it come from
+    # the other branches, and the reported generators must still generate
+    # the whole group.
+    cycle = [(i, (i + 1) % 6) for i in range(6)]
+    triangles = [(6, 7), (7, 8), (6, 8), (9, 10), (10, 11), (9, 11)]
+    g = bliss.Graph.from_edge_array(
+        12, np.array(cycle + triangles, dtype=np.uint32)
+    )
+    stats = bliss.Stats()
+    for n_threads in [1, 3]:
+        generators = []
+        g.find_automorphisms(
+            stats,
+            lambda n, aut: generators.append(aut.copy()),
+            n_threads=n_threads,
+        )
+        assert stats.group_size == 12 * 72
+        group = bliss.PermutationGroup(np.array(generators))
+        assert group.order() == stats.group_size
+
+
+def test_portfolio():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    portfolio = [
+        bliss.Graph.SplittingHeuristic.shs_f,
+        bliss.Graph.SplittingHeuristic.shs_fsm,
+        bliss.Graph.SplittingHeuristic.shs_flm,
+    ]
+    stats = bliss.Stats()
+    generators = []
+    petersen.find_automorphisms(
+        stats, lambda n, aut: generators.append(aut.copy()), portfolio=portfolio
+    )
+    assert stats.completed
+    assert stats.group_size == 120
+    assert stats.portfolio_winner in range(len(portfolio))
+    assert len(generators) == stats.n_generators
+    assert all(petersen.is_automorphism(aut) for aut in generators)
+
+    petersen.find_automorphisms(stats)
+    assert stats.portfolio_winner is None
+
+    with pytest.raises(RuntimeError):
+        petersen.find_automorphisms(stats, portfolio=[])
+
+
+def test_pickle():
+    import pickle
+
+    g = bliss.Graph.from_edge_array(
+        5,
+        np.array([[0, 1], [1, 2], [2, 3], [3, 3], [1, 0]], dtype=np.uint32),
+        np.array([0, 7, 0, 300, 1], dtype=np.uint32),
+    )
+    g.set_splitting_heuristic(bliss.Graph.SplittingHeuristic.shs_flm)
+    data = g.to_bytes()
+    assert bliss.Graph.from_bytes(data) == g
+    assert bliss.Graph.from_bytes(memoryview(data)).to_bytes() == data
+
+    for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+        assert pickle.loads(pickle.dumps(g, protocol=protocol)) == g
+
+    buffers = []
+    pickled = pickle.dumps(g, protocol=5, buffer_callback=buffers.append)
+    assert len(buffers) == 1
+    restored = pickle.loads(pickled, buffers=buffers)
+    assert restored.to_bytes() == data
+
+    with pytest.raises(RuntimeError):
+        bliss.Graph.from_bytes(data[:-1])
+    with pytest.raises(RuntimeError):
+        bliss.Digraph.from_bytes(data)
+
+
+def test_from_csr_frozen_graph():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    indptr, indices, colors = petersen.to_csr()
+    assert bliss.Graph.from_csr(indptr, indices, colors) == petersen
+    # the int32 arrays of scipy.sparse are accepted as they are
+    assert (
+        bliss.Graph.from_csr(indptr.astype(np.int32), indices.astype(np.int32))
+        == petersen
+    )
+    with pytest.raises(RuntimeError):
+        bliss.Graph.from_csr(np.array([0, 1, 1]), np.array([1], np.uint32))
+    # a row extending past the end of 'indices' is rejected before it is read
+    with pytest.raises(RuntimeError):
+        bliss.Graph.from_csr(np.array([0, 100, 1]), np.array([0], np.uint32))
+    with pytest.raises(RuntimeError):
+        bliss.FrozenGraph(np.array([0, 100, 1]), np.array([0], np.uint32))
+
+    frozen = bliss.FrozenGraph(indptr, indices, colors)
+    assert frozen.nvertices == 10
+    assert frozen.nedges == 15
+    np.testing.assert_array_equal(
+        frozen.neighbors(0), indices[indptr[0] : indptr[1]]
+    )
+    assert frozen.to_graph() == petersen
+
+    stats = bliss.Stats()
+    generators = frozen.automorphism_generators(stats)
+    assert stats.group_size == 120
+    assert all(frozen.is_automorphism(aut) for aut in generators)
+    assert not frozen.is_automorphism(
+        np.array([1, 0, *range(2, 10)], dtype=np.uint32)
+    )
+    perm = frozen.get_permutation_to_canonical_form(stats)
+    np.testing.assert_array_equal(
+        perm, petersen.get_permutation_to_canonical_form(stats)
+    )
+
+
+def test_search_context_out():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    stats = bliss.Stats()
+    context = bliss.SearchContext()
+    certificate, h = petersen.canonical_certificate(stats)
+    for _ in range(3):
+        assert petersen.canonical_certificate(stats, context=context) == (
+            certificate,
+            h,
+        )
+    nbytes = context.nbytes
+    assert nbytes > 0
+    context.clear()
+    assert context.nbytes < nbytes
+
+    out = np.empty(petersen.nvertices, dtype=np.uint32)
+    result = petersen.get_permutation_to_canonical_form(stats, out=out)
+    assert result is out
+    np.testing.assert_array_equal(
+        out, petersen.get_permutation_to_canonical_form(stats)
+    )
+    with pytest.raises(RuntimeError):
+        petersen.get_permutation_to_canonical_form(
+            stats, out=np.empty(petersen.nvertices, dtype=np.int64)
+        )
+
+    # The parallel search keeps its labeling and certificate scratch in the
+    # context.
+    expected = petersen.parallel_canonical_labeling(stats, n_threads=2)
+    for _ in range(3):
+        result = petersen.parallel_canonical_labeling(
+            stats, n_threads=2, out=out, context=context
+        )
+        assert result is out
+        np.testing.assert_array_equal(out, expected)
+    assert context.nbytes > 0
+
+
+def test_many_permutations():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    generators = petersen.automorphism_generators(bliss.Stats())
+    identity = np.arange(petersen.nvertices, dtype=np.uint32)
+    not_a_perm = identity.copy()
+    not_a_perm[0] = 1
+    shift = np.roll(identity, 1)
+    perms = np.vstack([generators, identity, not_a_perm, shift])
+    assert perms.flags.c_contiguous
+    result = petersen.is_automorphism_many(perms, n_threads=2)
+    assert result.dtype == np.bool_
+    assert result[: len(generators) + 1].all()
+    assert not result[-2]
+    assert result[-1] == petersen.is_automorphism(shift)
+
+    rng = np.random.default_rng(0)
+    perms = np.vstack(
+        [identity, *generators]
+        + [rng.permutation(10).astype(np.uint32) for _ in range(5)]
+    )
+    edges, colors = petersen.permute_many(perms)
+    assert edges.shape == (len(perms), 15, 2)
+    assert colors.shape == (len(perms), petersen.nvertices)
+    for perm, perm_edges, perm_colors in zip(perms, edges, colors):
+        e, c = petersen.permute(perm).to_edge_array()
+        assert sorted(map(tuple, perm_edges)) == sorted(map(tuple, e))
+        np.testing.assert_array_equal(perm_colors, c)
+
+    certificates = petersen.permute_many(
+        perms, output="certificate", n_threads=2
+    )
+    assert len(set(certificates[: len(generators) + 1])) == 1
+    canonical_perm = petersen.get_permutation_to_canonical_form(bliss.Stats())
+    certificate, _ = petersen.canonical_certificate(bliss.Stats())
+    assert petersen.permute_many(
+        canonical_perm[np.newaxis, :], output="certificate"
+    ) == [certificate]
+
+    with pytest.raises(RuntimeError):
+        petersen.permute_many(not_a_perm[np.newaxis, :])
+    with pytest.raises(RuntimeError):
+        petersen.permute_many(perms, output="graphs")
+    with pytest.raises(RuntimeError):
+        petersen.is_automorphism_many(perms[:, :-1].copy())
+
+
+def test_stats_profile():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    stats = bliss.Stats()
+    petersen.find_automorphisms(stats)
+    assert stats.profile is None
+
+    stats = bliss.Stats(profiling=True)
+    petersen.find_automorphisms(stats, lambda n, aut: None)
+    profile = stats.profile
+    assert profile["n_generators"] == stats.n_generators
+    assert profile["n_nodes"] > 0
+    assert 0 <= profile["first_node_time"] <= profile["total_time"]
+    assert 0 <= profile["report_time"] <= profile["total_time"]
+    assert profile["n_progress_calls"] == 0
+
+    samples = []
+    stats = bliss.Stats(progress=samples.append, progress_interval=1e-9)
+    petersen.canonical_certificate(stats)
+    assert samples
+    assert stats.profile["n_progress_calls"] == len(samples)
+    assert [s["n_progress_calls"] for s in samples] == list(
+        range(1, len(samples) + 1)
+    )
+
+    def interrupt(profile):
+        raise KeyboardInterrupt
+
+    with pytest.raises(KeyboardInterrupt):
+        petersen.find_automorphisms(
+            bliss.Stats(progress=interrupt, progress_interval=1e-9)
+        )
+    with pytest.raises(RuntimeError):
+        bliss.Stats(progress_interval=0)
+
+
+def test_are_isomorphic():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    rng = np.random.default_rng(0)
+    perm = rng.permutation(10).astype(np.uint32)
+    permuted = petersen.permute(perm)
+    permuted.set_splitting_heuristic(bliss.Graph.SplittingHeuristic.shs_fl)
+
+    iso = bliss.are_isomorphic(petersen, permuted)
+    assert iso.dtype == np.uint32
+    assert petersen.permute(iso).cmp(permuted) == 0
+    np.testing.assert_array_equal(
+        bliss.are_isomorphic(petersen, petersen), np.arange(10)
+    )
+
+    # Long prune may change the canonical labeling: the graphs must still
+    # be found isomorphic when only that option differs.
+    for long_prune in [False, True]:
+        g1 = petersen.copy()
+        g2 = petersen.permute(perm)
+        g1.set_long_prune_activity(long_prune)
+        g2.set_long_prune_activity(not long_prune)
+        iso = bliss.are_isomorphic(g1, g2)
+        assert g1.permute(iso).cmp(g2) == 0
+
+    # Same degree sequence and refinement invariant, not isomorphic.
+    prism = bliss.Graph(10)
+    for i in range(5):
+        prism.add_edge(i, (i + 1) % 5)
+        prism.add_edge(5 + i, 5 + (i + 1) % 5)
+        prism.add_edge(i, 5 + i)
+    assert bliss.are_isomorphic(petersen, prism) is None
+    assert bliss.are_isomorphic(petersen, bliss.Graph(10)) is None
+    assert bliss.are_isomorphic(petersen, bliss.Graph(9)) is None
+    recolored = petersen.copy()
+    recolored.change_color(0, 1)
+    assert bliss.are_isomorphic(petersen, recolored) is None
+    with pytest.raises(TypeError):
+        bliss.are_isomorphic(petersen, bliss.Digraph(10))
+
+
+def test_canonical_labeling_by_components():
+    petersen = bliss.Graph.from_graph6(b"IheA@GUAo")
+    petersen_edges, _ = petersen.to_edge_array()
+    # Three copies of the Petersen graph, a path and an isolated vertex.
+    edges = [petersen_edges + 10 * i for i in range(3)]
+    edges.append(np.array([[30, 31], [31, 32]], dtype=np.uint32))
+    g = bliss.Graph.from_edge_array(34, np.vstack(edges).astype(np.uint32))
+
+    cache = bliss.ComponentCache(max_size=16)
+    labeling = g.canonical_labeling_by_components(cache)
+    assert sorted(labeling.tolist()) == list(range(34))
+    # The Petersen graph is searched once, the path once.
+    assert cache.misses == 2
+    assert cache.hits == 2
+    assert cache.size == 2
+
+    rng = np.random.default_rng(0)
+    perm = rng.permutation(34).astype(np.uint32)
+    h = g.permute(perm)
+    h_labeling = h.canonical_labeling_by_components(cache)
+    assert g.permute(labeling).cmp(h.permute(h_labeling)) == 0
+    np.testing.assert_array_equal(
+        g.canonical_labeling_by_components(), labeling
+    )
+
+    # Every search option is part of the cache keys.
+    no_long_prune = g.copy()
+    no_long_prune.set_long_prune_activity(False)
+    misses = cache.misses
+    no_long_prune.canonical_labeling_by_components(cache)
+    assert cache.misses == misses + 2
+
+    cache.clear()
+    assert cache.size == cache.hits == cache.misses == 0
+    with pytest.raises(TypeError):
+        bliss.ComponentCache(max_size=-1)
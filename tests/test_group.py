@@ -0,0 +1,49 @@
+import math
+
+import numpy as np
+import pytest
+
+import pybliss as bliss
+
+
+def _symmetric_group_generators(n):
+    transposition = np.arange(n, dtype=np.uint32)
+    transposition[[0, 1]] = [1, 0]
+    cycle = np.roll(np.arange(n, dtype=np.uint32), -1)
+    return np.array([transposition, cycle])
+
+
+@pytest.mark.parametrize("n", [1, 2, 5, 30])
+def test_symmetric_group_order(n):
+    group = bliss.PermutationGroup(_symmetric_group_generators(n))
+    assert group.degree == n
+    assert group.order() == math.factorial(n)
+
+
+def test_permutation_group_from_automorphisms():
+    g = bliss.Graph.from_graph6(b"IheA@GUAo")
+    stats = bliss.Stats()
+    group = bliss.PermutationGroup(g.automorphism_generators(stats), seed=42)
+    assert group.order() == stats.group_size == 120
+
+    elements = np.array([group.random_element() for _ in range(50)])
+    assert all(g.is_automorphism(perm) for perm in elements)
+    assert group.contains(elements[0])
+    assert group.contains(elements).all()
+
+    non_automorphism = np.arange(10, dtype=np.uint32)
+    non_automorphism[[0, 1]] = [1, 0]
+    assert not g.is_automorphism(non_automorphism)
+    assert not group.contains(non_automorphism)
+    assert group.contains(
+        np.array([non_automorphism, elements[1]]), n_threads=2
+    ).tolist() == [False, True]
+
+    chain = group.stabilizer_chain()
+    assert [point for point, _, _ in chain] == group.base.tolist()
+    assert math.prod(len(orbit) for _, orbit, _ in chain) == 120
+    assert chain[0][2].shape[1] == 10
+    assert group.strong_generators().shape[1] == 10
+
+    with pytest.raises(RuntimeError):
+        group.contains(np.zeros(10, dtype=np.uint32))